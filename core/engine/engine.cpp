@@ -4,6 +4,7 @@
 /* file COPYING or http://www.opensource.org/licenses/mit-license.php         */
 /******************************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "engine.h"
@@ -181,7 +182,7 @@ rt_void print_lgt(rt_pstr mgn, rt_ELEM *elm, rt_Object *obj)
 static
 rt_pstr tags[RT_TAG_SURFACE_MAX] =
 {
-    "PL", "CL", "SP", "CN", "PB", "HB", "PC", "HC", "HP"
+    "PL", "CL", "SP", "CN", "PB", "HB", "PC", "HC", "HP", "DF"
 };
 
 static
@@ -402,6 +403,24 @@ rt_void print_lst(rt_pstr mgn, rt_ELEM *elm)
         print_lst("    ", lst);                                             \
         RT_LOGI("\n")
 
+/*
+ * Print heap's memory accounting (sizes in bytes),
+ * "rsv" is heap's per-frame reserve size.
+ */
+static
+rt_void print_mem(rt_pstr mgn, rt_pstr name, rt_MSTAT *mst, rt_size rsv)
+{
+    RT_LOGI("%s", mgn);
+    RT_LOGI("%-10s cmt: %10ld, live: %10ld, peak: %10ld, ",
+        name, (long)mst->cmt, (long)mst->live, (long)mst->peak);
+    RT_LOGI("chunks: %4d, rsv: %10ld", mst->chunks, (long)rsv);
+    RT_LOGI("\n");
+}
+
+#define RT_PRINT_MEM_INIT()                                                 \
+        RT_LOGI("******************** MEMORY *******************");           \
+        RT_LOGI("\n")
+
 #define RT_PRINT_STATE_DONE()                                               \
         RT_LOGI("*********************************************");           \
         RT_LOGI("*********************************************");           \
@@ -485,23 +504,31 @@ rt_void update_scene(rt_void *tdata, rt_si32 thnum, rt_si32 phase)
 static
 rt_void render_scene(rt_void *tdata, rt_si32 thnum, rt_si32 phase)
 {
-    rt_Scene *scn;
+    /* render is completed when started, nothing to wait for */
+    if ((phase & RT_RENDER_WAIT) != 0)
+    {
+        return;
+    }
+
+    rt_si32 i;
 
     if (thnum < 0)
     {
-        scn = (rt_Scene *)tdata;
-        thnum = -thnum;
+        rt_Scene *scn = (rt_Scene *)tdata;
+
+        for (i = 0; i < -thnum; i++)
+        {
+            scn->render_slice(i, phase & 0xFF);
+        }
     }
     else
     {
-        scn = ((rt_Platform *)tdata)->get_cur_scene();
-    }
-
-    rt_si32 i;
+        rt_Platform *pfm = (rt_Platform *)tdata;
 
-    for (i = 0; i < thnum; i++)
-    {
-        scn->render_slice(i, phase);
+        for (i = 0; i < thnum; i++)
+        {
+            pfm->render_slice(i, phase & 0xFF);
+        }
     }
 }
 
@@ -523,6 +550,9 @@ rt_Platform::rt_Platform(rt_FUNC_ALLOC f_alloc, rt_FUNC_FREE f_free,
     /* init scene list variables */
     head = tail = cur = RT_NULL;
 
+    b_arr = RT_NULL;
+    b_num = 0;
+
     /* allocate root SIMD structure */
     s_inf = (rt_SIMD_INFOX *)
             alloc(sizeof(rt_SIMD_INFOX),
@@ -569,6 +599,16 @@ rt_Platform::rt_Platform(rt_FUNC_ALLOC f_alloc, rt_FUNC_FREE f_free,
     tile_h = RT_MAX(RT_TILE_H, 1);
     tile_w = ((tile_w + RT_SIMD_WIDTH - 1) / RT_SIMD_WIDTH) * RT_SIMD_WIDTH;
 
+    /* init SIMD target autotune mode (off) */
+    t_frms = 0;
+    t_cach = 0;
+    t_scn = RT_NULL;
+
+    /* init event tracing mode (off) */
+    trc_arr = RT_NULL;
+    trc_num = 0;
+    trc_on = 0;
+
     /* init rendering backend,
      * default SIMD runtime target will be chosen */
     fsaa = RT_FSAA_NO;
@@ -619,6 +659,14 @@ rt_void simd_version(rt_SIMD_INFOX *s_inf)
     ASM_LEAVE(s_inf)
 }
 
+/*
+ * Get current runtime SIMD target (in set_simd format).
+ */
+rt_si32 rt_Platform::get_simd()
+{
+    return simd;
+}
+
 /*
  * Set current runtime SIMD target with "simd" equal to
  * SIMD native-size (1,..,16) in 0th (lowest) byte
@@ -656,6 +704,179 @@ rt_si32 rt_Platform::set_simd(rt_si32 simd)
     return simd;
 }
 
+/*
+ * Set SIMD target autotune mode with "frms" warm-up frames per target
+ * (0 - off), when enabled each scene picks the fastest supported target
+ * on its first render after becoming current (see rt_Scene::tune_simd).
+ * Non-zero "cach" reuses/stores the choice per CPU in the cache file,
+ * which then takes precedence over re-tuning for each new scene.
+ */
+rt_si32 rt_Platform::set_tune(rt_si32 frms, rt_si32 cach)
+{
+    t_frms = RT_MAX(frms, 0);
+    t_cach = cach;
+    t_scn = RT_NULL;
+
+    return t_frms;
+}
+
+/*
+ * Set event tracing mode with "size" events per ring (0 - off),
+ * one ring for the main thread and one for each worker thread.
+ * Rings are allocated on first enable and kept until platform's
+ * destruction (re-enabling keeps their initial size), this allows
+ * workers to record events without locks, call between frames only.
+ */
+rt_si32 rt_Platform::set_trace(rt_si32 size)
+{
+    rt_si32 i;
+
+    if (trc_arr == RT_NULL && size > 0)
+    {
+        trc_num = thnum + 1;
+        trc_arr = (rt_TRACE *)f_alloc(trc_num * sizeof(rt_TRACE) +
+                                      trc_num * size * sizeof(rt_EVENT));
+
+        if (trc_arr == RT_NULL)
+        {
+            throw rt_Exception("out of memory for trace rings");
+        }
+
+        rt_EVENT *evts = (rt_EVENT *)(trc_arr + trc_num);
+
+        for (i = 0; i < trc_num; i++)
+        {
+            trc_arr[i].evts = evts + i * size;
+            trc_arr[i].size = size;
+            trc_arr[i].cnt = 0;
+        }
+    }
+
+    trc_on = size > 0 && trc_arr != RT_NULL;
+    trace = get_trace(0);
+
+    return trc_on ? trc_arr[0].size : 0;
+}
+
+/*
+ * Get event trace ring with given "index" (0 - main thread,
+ * i+1 - i-th worker thread), returns RT_NULL if tracing is off.
+ */
+rt_TRACE* rt_Platform::get_trace(rt_si32 index)
+{
+    if (trc_on == 0 || index < 0 || index >= trc_num)
+    {
+        return RT_NULL;
+    }
+
+    return &trc_arr[index];
+}
+
+/*
+ * Record main thread's event "name" started at "time" and ending now.
+ */
+rt_void rt_Platform::add_trace(rt_pstr name, rt_time time)
+{
+    rt_TRACE *trc = get_trace(0);
+
+    if (trc != RT_NULL)
+    {
+        trace_event(trc, name, time, get_usec() - time, 0);
+    }
+}
+
+/*
+ * Save recorded events from all trace rings to a JSON file
+ * in Chrome trace event format (chrome://tracing, Perfetto UI).
+ */
+rt_void rt_Platform::save_trace(rt_si32 index)
+{
+    if (trc_arr == RT_NULL)
+    {
+        return;
+    }
+
+    rt_char name[20];
+
+    strncpy(name, "trcXXX.json", 20);
+
+    /* prepare filename string */
+    name[5] = '0' + (index % 10);
+    index /= 10;
+    name[4] = '0' + (index % 10);
+    index /= 10;
+    name[3] = '0' + (index % 10);
+
+    rt_pstr path = RT_PATH_DUMP;
+    rt_size len = strlen(path);
+    rt_char *fullpath = (rt_char *)alloc(len + strlen(name) + 1, 0);
+
+    strcpy(fullpath, path);
+    strcpy(fullpath + len, name);
+
+    rt_File fl(fullpath, "w+");
+    rt_File *f = &fl;
+
+    /* release memory for temporary fullpath string,
+     * would also release all allocs made after fullpath */
+    release(fullpath);
+
+    if (f->error() != 0)
+    {
+        return;
+    }
+
+    rt_si32 i;
+
+    f->fprint("{\"traceEvents\":[\n");
+
+    /* name trace lanes after threads */
+    for (i = 0; i < trc_num; i++)
+    {
+        if (i == 0)
+        {
+            f->fprint("{\"name\":\"thread_name\",\"ph\":\"M\","
+                "\"pid\":1,\"tid\":0,\"args\":{\"name\":\"main\"}}");
+        }
+        else
+        {
+            f->fprint(",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+                "\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"worker %d\"}}",
+                i, i - 1);
+        }
+    }
+
+    /* dump each ring from its oldest event */
+    for (i = 0; i < trc_num; i++)
+    {
+        rt_TRACE *trc = &trc_arr[i];
+        rt_time n = RT_MIN(trc->cnt, (rt_time)trc->size);
+        rt_time k;
+
+        for (k = trc->cnt - n; k < trc->cnt; k++)
+        {
+            rt_EVENT *evt = &trc->evts[k % trc->size];
+
+            if (evt->dur >= 0)
+            {
+                f->fprint(",\n{\"name\":\"%s\",\"ph\":\"X\","
+                    "\"ts\":%ld,\"dur\":%ld,", evt->name,
+                    (long)evt->time, (long)evt->dur);
+            }
+            else
+            {
+                f->fprint(",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\","
+                    "\"ts\":%ld,", evt->name, (long)evt->time);
+            }
+
+            f->fprint("\"pid\":1,\"tid\":%d,\"args\":{\"size\":%ld}}",
+                i, (long)evt->arg);
+        }
+    }
+
+    f->fprint("\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
 /*
  * Set current antialiasing mode.
  */
@@ -750,6 +971,10 @@ rt_void rt_Platform::del_scene(rt_Scene *scn)
     {
         cur = head;
     }
+    if (t_scn == scn)
+    {
+        t_scn = RT_NULL;
+    }
 }
 
 /*
@@ -799,6 +1024,93 @@ rt_void rt_Platform::next_scene()
     }
 }
 
+/*
+ * Render "num" distinct scenes from "scn" array for respective "time"
+ * in one dispatch of the thread pool, block until all are finished.
+ * Scenes are updated one after another (each using the whole pool),
+ * then their slices are spread over the pool together, so that several
+ * small viewports fill the cores at once instead of taking turns.
+ * Scenes must not share their frames, while SIMD target and antialiasing
+ * mode are platform-wide. Current scene is the same upon return.
+ * Can only be called from single (main) thread.
+ */
+rt_void rt_Platform::render_batch(rt_si32 num, rt_Scene **scn, rt_time *time)
+{
+    rt_Scene *scr = cur;
+    rt_si32 i, k;
+
+    /* finish frames in flight first, as the pool
+     * is used by the updates of the other scenes */
+    for (i = 0; i < num; i++)
+    {
+        scn[i]->render_wait();
+    }
+
+    for (i = 0, k = 0; i < num; i++)
+    {
+        /* update is only multi-threaded for current scene,
+         * which also enables thread pool in "render_init" */
+        cur = scn[i];
+
+        scn[i]->prepare(time[i]);
+
+        rt_si32 mode = scn[i]->render_init();
+
+        if (mode > 0)
+        {
+            scn[i]->posted = 3;
+            k++;
+        }
+        else
+        if (mode == 0)
+        {
+            render_scene(scn[i], -thnum, 1);
+        }
+    }
+
+    cur = scr;
+
+    if (k > 0)
+    {
+        b_arr = scn;
+        b_num = num;
+
+        this->f_render(tdata, thnum, 1);
+
+        b_arr = RT_NULL;
+        b_num = 0;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        scn[i]->render_wait();
+    }
+}
+
+/*
+ * Render "index"-th slice of current scene, or of every scene
+ * dispatched together by "render_batch" in turn.
+ * Called from platform's worker-threads.
+ */
+rt_void rt_Platform::render_slice(rt_si32 index, rt_si32 phase)
+{
+    rt_si32 i;
+
+    if (b_num == 0)
+    {
+        cur->render_slice(index, phase);
+        return;
+    }
+
+    for (i = 0; i < b_num; i++)
+    {
+        if (b_arr[i]->posted == 3)
+        {
+            b_arr[i]->render_slice(index, phase);
+        }
+    }
+}
+
 /*
  * Deinitialize platform.
  */
@@ -812,6 +1124,14 @@ rt_Platform::~rt_Platform()
     /* destroy platform-specific worker threads */
     this->f_term(tdata, thnum);
 
+    /* release event trace rings */
+    if (trc_arr != RT_NULL)
+    {
+        trace = RT_NULL;
+        f_free(trc_arr, trc_num * sizeof(rt_TRACE) +
+                        trc_num * trc_arr[0].size * sizeof(rt_EVENT));
+    }
+
     ASM_DONE(s_inf)
 }
 
@@ -874,6 +1194,12 @@ rt_SceneThread::rt_SceneThread(rt_Scene *scene, rt_si32 index) :
     s_inf->ptr_b   = scene->ptr_b;
     s_inf->pt_on   = scene->pt_on;
 
+    /* allocate thread's own occluder cache, one element per light,
+     * filled in backend, reset for every frame in "render_slice" */
+    occ = (rt_ELEM *)alloc(sizeof(rt_ELEM) * RT_MAX(scene->lgt_num, 1),
+                                                            RT_QUAD_ALIGN);
+    s_inf->occ = RT_NULL;
+
 #if   RT_PRNG == LCG16
 
     /* init PRNG's constants (32-bit LCG) */
@@ -947,10 +1273,23 @@ rt_SceneThread::rt_SceneThread(rt_Scene *scene, rt_si32 index) :
     mpool = RT_NULL;
     /* estimates are done in Scene once all counters have been initialized */
     msize = 0;
+    mbase = 0;
+    mpeak = 0;
+
+    /* spare heap is created in pipelined mode */
+    spare = RT_NULL;
+    spool = RT_NULL;
+    sbase = 0;
+
+    cpool = RT_NULL;
 
     /* allocate misc arrays for tiling */
     txmin = (rt_si32 *)alloc(sizeof(rt_si32) * scene->tiles_in_col, RT_ALIGN);
     txmax = (rt_si32 *)alloc(sizeof(rt_si32) * scene->tiles_in_col, RT_ALIGN);
+    tdx = (rt_real *)alloc(sizeof(rt_real) * (scene->tiles_in_row + 1), RT_ALIGN);
+    tdy = (rt_real *)alloc(sizeof(rt_real) * (scene->tiles_in_col + 1), RT_ALIGN);
+    tnx = (rt_vec4 *)alloc(sizeof(rt_vec4) * (scene->tiles_in_row + 1), RT_ALIGN);
+    tny = (rt_vec4 *)alloc(sizeof(rt_vec4) * (scene->tiles_in_col + 1), RT_ALIGN);
     verts = (rt_VERT *)alloc(sizeof(rt_VERT) * 
                              (2 * RT_VERTS_LIMIT + RT_EDGES_LIMIT), RT_ALIGN);
 }
@@ -1979,77 +2318,267 @@ rt_void rt_SceneThread::sclip(rt_Surface *srf)
 }
 
 /*
- * Build tile list for a given surface "srf" based
- * on the area its projected bbox occupies in the tilebuffer.
+ * Test if surface's bounding sphere with center "q" (relative to camera)
+ * and radius "r" intersects the sub-frustum of tile in row "i", column "j".
+ * Side planes' distances are precomputed in "tdx/tdy", corner rays are only
+ * traced if the center is outside of both planes adjacent to the corner
+ * and its projection onto either plane is outside of the other one,
+ * as off-axis sub-frustums have obtuse edges where the closest point
+ * can otherwise lie on a face rather than on the corner ray.
  */
-rt_void rt_SceneThread::stile(rt_Surface *srf)
+rt_bool rt_SceneThread::frustum(rt_si32 i, rt_si32 j, rt_vec4 q, rt_real r)
 {
-    /* as temporary memory pool is released after every frame,
-     * always rebuild the list even if the scene hasn't changed */
+    rt_real d[4];
+    rt_si32 k;
 
-    srf->tls = RT_NULL;
+    d[0] = +tdx[j + 0]; /* left   plane, positive inside */
+    d[1] = -tdx[j + 1]; /* right  plane, positive inside */
+    d[2] = +tdy[i + 0]; /* top    plane, positive inside */
+    d[3] = -tdy[i + 1]; /* bottom plane, positive inside */
 
-#if RT_OPTS_TILING != 0
-    if ((scene->opts & RT_OPTS_TILING) == 0)
-#endif /* RT_OPTS_TILING */
+    for (k = 0; k < 4; k++)
     {
-        return;
+        if (d[k] < -r)
+        {
+            return RT_FALSE;
+        }
     }
 
-    rt_ELEM *elm;
-    rt_si32 i, j;
-    rt_si32 k;
+    /* process 4 corner rays */
+    for (k = 0; k < 4; k++)
+    {
+        rt_si32 x = k & 1, y = k >> 1;
 
-    rt_vec4 vec;
-    rt_real dot;
-    rt_si32 ndx[2];
-    rt_real tag[2], zed[2];
+        if (d[0 + x] >= 0.0f || d[2 + y] >= 0.0f)
+        {
+            continue;
+        }
 
-    /* "verts_num" may grow, use "srf->verts_num" if original is needed */
-    rt_si32 verts_num = srf->bvbox->verts_num;
-    rt_VERT *vrt = srf->bvbox->verts;
+        /* cosine between planes' inside normals */
+        rt_real c = RT_VEC3_DOT(tnx[j + x], tny[i + y]) * (x ^ y ? -1 : +1);
 
-    /* project bbox onto the tilebuffer */
-    if (verts_num != 0)
-    {
-        for (i = 0; i < scene->tiles_in_col; i++)
+        /* closest point is on a face (within "r" by the tests above)
+         * if center's projection onto one plane is inside the other */
+        if (d[2 + y] - d[0 + x] * c >= 0.0f
+        ||  d[0 + x] - d[2 + y] * c >= 0.0f)
         {
-            txmin[i] = scene->tiles_in_row;
-            txmax[i] = -1;
+            continue;
         }
 
-        /* process bbox vertices */
-        memset(verts, 0, sizeof(rt_VERT) *
-                         (2 * verts_num + srf->bvbox->edges_num));
+        rt_vec4 vec, crs;
 
-        for (k = 0; k < srf->bvbox->verts_num; k++)
+        RT_VEC3_SET(vec, scene->dir);
+        RT_VEC3_MAD_VAL1(vec, scene->hor, (j + x) * scene->factor
+                                          * scene->pfm->tile_w);
+        RT_VEC3_MAD_VAL1(vec, scene->ver, (i + y) * scene->factor
+                                          * scene->pfm->tile_h);
+
+        rt_real dst = RT_VEC3_DOT(q, q);
+
+        /* distance to ray if closest point is in front of camera */
+        if (RT_VEC3_DOT(q, vec) > 0.0f)
         {
-            RT_VEC3_SUB(vec, vrt[k].pos, scene->org);
+            RT_VEC3_MUL(crs, q, vec);
+            dst = RT_VEC3_DOT(crs, crs) / RT_VEC3_DOT(vec, vec);
+        }
 
-            dot = RT_VEC3_DOT(vec, scene->nrm);
+        if (dst > r * r)
+        {
+            return RT_FALSE;
+        }
+    }
 
-            verts[k].pos[RT_Z] = dot;
-            verts[k].pos[RT_W] = -1.0f; /* tag: behind screen plane */
+    return RT_TRUE;
+}
 
-            /* process vertices in front of or near screen plane,
-             * the rest are processed with edges */
-            if (dot >= 0.0f || RT_FABS(dot) <= RT_CLIP_THRESHOLD)
-            {
-                RT_VEC3_SUB(vec, vrt[k].pos, scene->pos);
+/*
+ * Shrink surface's projected bbox boundaries in the tilebuffer
+ * by testing its bounding sphere against tiles' sub-frustums,
+ * tiles at both ends of each row are removed while not intersected.
+ */
+rt_void rt_SceneThread::frustum(rt_Surface *srf)
+{
+    rt_vec4 q, c0, c1, nrm;
+    rt_real r, s, t;
+    rt_si32 i, j;
 
-                dot = RT_VEC3_DOT(vec, scene->nrm) / scene->cam->pov;
+    r = srf->bvbox->rad;
 
-                RT_VEC3_MUL_VAL1(vec, vec, 1.0f / dot);
-                /* dot >= (pov - RT_CLIP_THRESHOLD) */
-                /* pov >= (2  *  RT_CLIP_THRESHOLD) */
-                /* thus: (dot >= RT_CLIP_THRESHOLD) */
+    RT_VEC3_SUB(q, srf->bvbox->mid, scene->pos);
 
-                RT_VEC3_SUB(vec, vec, scene->dir);
+    /* sphere's own bounds are tighter than
+     * bounding sphere of its bbox vertices */
+    if (srf->tag == RT_TAG_SPHERE)
+    {
+        rt_mat4 mtx;
 
-                verts[k].pos[RT_X] = RT_VEC3_DOT(vec, scene->htl);
-                verts[k].pos[RT_Y] = RT_VEC3_DOT(vec, scene->vtl);
+        /* surface's matrix is relative to trnode
+         * if its own transform is trivial (transform caching) */
+        if (srf->trnode != RT_NULL && srf->trnode != srf)
+        {
+            matrix_mul_matrix(mtx, srf->trnode->mtx, srf->mtx);
+        }
+        else
+        {
+            memcpy(mtx, srf->mtx, sizeof(rt_mat4));
+        }
 
-                verts[k].pos[RT_W] = +1.0f; /* tag: in front of screen plane */
+        s = RT_MAX(RT_VEC3_DOT(mtx[0], mtx[0]),
+            RT_MAX(RT_VEC3_DOT(mtx[1], mtx[1]),
+                   RT_VEC3_DOT(mtx[2], mtx[2])));
+
+        s = RT_SQRT(s * srf->shape->sci[RT_W]);
+
+        if (r > s)
+        {
+            r = s;
+
+            RT_VEC3_SUB(q, mtx[3], scene->pos);
+        }
+    }
+
+    r *= 1.0f + RT_FRST_THRESHOLD;
+
+    /* compute distances to vertical planes through camera and
+     * tiles' columns boundaries, positive towards "hor" */
+    RT_VEC3_MUL(c0, scene->ver, scene->dir);
+    RT_VEC3_MUL(c1, scene->ver, scene->hor);
+
+    s = scene->factor * scene->pfm->tile_w;
+
+    for (j = 0; j <= scene->tiles_in_row; j++)
+    {
+        RT_VEC3_SET(nrm, c0);
+        RT_VEC3_MAD_VAL1(nrm, c1, j * s);
+
+        t = RT_VEC3_DOT(nrm, scene->hor) < 0.0f ? -1.0f : +1.0f;
+
+        RT_VEC3_MUL_VAL1(tnx[j], nrm, t / RT_VEC3_LEN(nrm));
+
+        tdx[j] = RT_VEC3_DOT(q, tnx[j]);
+    }
+
+    /* compute distances to horizontal planes through camera and
+     * tiles' rows boundaries, positive towards "ver" */
+    RT_VEC3_MUL(c0, scene->hor, scene->dir);
+    RT_VEC3_MUL(c1, scene->hor, scene->ver);
+
+    s = scene->factor * scene->pfm->tile_h;
+
+    for (i = 0; i <= scene->tiles_in_col; i++)
+    {
+        RT_VEC3_SET(nrm, c0);
+        RT_VEC3_MAD_VAL1(nrm, c1, i * s);
+
+        t = RT_VEC3_DOT(nrm, scene->ver) < 0.0f ? -1.0f : +1.0f;
+
+        RT_VEC3_MUL_VAL1(tny[i], nrm, t / RT_VEC3_LEN(nrm));
+
+        tdy[i] = RT_VEC3_DOT(q, tny[i]);
+    }
+
+    /* sphere's intersection with each row's sub-frustum is convex,
+     * thus intersected tiles are contiguous within the row */
+    for (i = 0; i < scene->tiles_in_col; i++)
+    {
+        if (tdy[i] < -r || tdy[i + 1] > r)
+        {
+            txmin[i] = scene->tiles_in_row;
+            txmax[i] = -1;
+            continue;
+        }
+
+        while (txmin[i] <= txmax[i] && !frustum(i, txmin[i], q, r))
+        {
+            txmin[i]++;
+        }
+
+        while (txmax[i] >= txmin[i] && !frustum(i, txmax[i], q, r))
+        {
+            txmax[i]--;
+        }
+    }
+}
+
+/*
+ * Build tile list for a given surface "srf" based
+ * on the area its projected bbox occupies in the tilebuffer.
+ */
+rt_void rt_SceneThread::stile(rt_Surface *srf)
+{
+    /* as temporary memory pool is released after every frame,
+     * always rebuild the list even if the scene hasn't changed */
+
+    srf->tls = RT_NULL;
+    srf->tlr = RT_NULL;
+
+    /* reset projected tile-rect to the entire tilebuffer */
+    srf->tbx[0] = 0;
+    srf->tbx[1] = 0;
+    srf->tbx[2] = scene->tiles_in_row - 1;
+    srf->tbx[3] = scene->tiles_in_col - 1;
+
+#if RT_OPTS_TILING != 0
+    if ((scene->opts & RT_OPTS_TILING) == 0)
+#endif /* RT_OPTS_TILING */
+    {
+        return;
+    }
+
+    rt_ELEM *elm;
+    rt_si32 i, j;
+    rt_si32 k;
+
+    rt_vec4 vec;
+    rt_real dot;
+    rt_si32 ndx[2];
+    rt_real tag[2], zed[2];
+
+    /* "verts_num" may grow, use "srf->verts_num" if original is needed */
+    rt_si32 verts_num = srf->bvbox->verts_num;
+    rt_VERT *vrt = srf->bvbox->verts;
+
+    /* project bbox onto the tilebuffer */
+    if (verts_num != 0)
+    {
+        for (i = 0; i < scene->tiles_in_col; i++)
+        {
+            txmin[i] = scene->tiles_in_row;
+            txmax[i] = -1;
+        }
+
+        /* process bbox vertices */
+        memset(verts, 0, sizeof(rt_VERT) *
+                         (2 * verts_num + srf->bvbox->edges_num));
+
+        for (k = 0; k < srf->bvbox->verts_num; k++)
+        {
+            RT_VEC3_SUB(vec, vrt[k].pos, scene->org);
+
+            dot = RT_VEC3_DOT(vec, scene->nrm);
+
+            verts[k].pos[RT_Z] = dot;
+            verts[k].pos[RT_W] = -1.0f; /* tag: behind screen plane */
+
+            /* process vertices in front of or near screen plane,
+             * the rest are processed with edges */
+            if (dot >= 0.0f || RT_FABS(dot) <= RT_CLIP_THRESHOLD)
+            {
+                RT_VEC3_SUB(vec, vrt[k].pos, scene->pos);
+
+                dot = RT_VEC3_DOT(vec, scene->nrm) / scene->cam->pov;
+
+                RT_VEC3_MUL_VAL1(vec, vec, 1.0f / dot);
+                /* dot >= (pov - RT_CLIP_THRESHOLD) */
+                /* pov >= (2  *  RT_CLIP_THRESHOLD) */
+                /* thus: (dot >= RT_CLIP_THRESHOLD) */
+
+                RT_VEC3_SUB(vec, vec, scene->dir);
+
+                verts[k].pos[RT_X] = RT_VEC3_DOT(vec, scene->htl);
+                verts[k].pos[RT_Y] = RT_VEC3_DOT(vec, scene->vtl);
+
+                verts[k].pos[RT_W] = +1.0f; /* tag: in front of screen plane */
 
                 /* slightly behind (near) screen plane,
                  * generate new vertex */
@@ -2124,6 +2653,16 @@ rt_void rt_SceneThread::stile(rt_Surface *srf)
                 tiling(verts[i].pos, verts[j].pos); 
             }
         }
+
+#if RT_OPTS_TILING_EXT2 != 0
+        /* cull tiles which are covered by projected bbox,
+         * but not by surface's bounding sphere */
+        if ((scene->opts & RT_OPTS_TILING_EXT2) != 0
+        &&  srf->bvbox->rad < RT_INF)
+        {
+            frustum(srf);
+        }
+#endif /* RT_OPTS_TILING_EXT2 */
     }
     else
     {
@@ -2137,9 +2676,40 @@ rt_void rt_SceneThread::stile(rt_Surface *srf)
 
     rt_ELEM **ptr = RT_GET_ADR(srf->tls);
 
-    /* fill marked tiles with surface data */
+    /* reset projected tile-rect to empty */
+    srf->tbx[0] = scene->tiles_in_row;
+    srf->tbx[1] = scene->tiles_in_col;
+    srf->tbx[2] = -1;
+    srf->tbx[3] = -1;
+
+    /* accumulate projected tile-rect */
     for (i = 0; i < scene->tiles_in_col; i++)
     {
+        if (txmin[i] <= txmax[i])
+        {
+            srf->tbx[0] = RT_MIN(srf->tbx[0], txmin[i]);
+            srf->tbx[1] = RT_MIN(srf->tbx[1], i);
+            srf->tbx[2] = RT_MAX(srf->tbx[2], txmax[i]);
+            srf->tbx[3] = RT_MAX(srf->tbx[3], i);
+        }
+    }
+
+    if (srf->tbx[3] < srf->tbx[1])
+    {
+       *ptr = RT_NULL;
+        return;
+    }
+
+    /* alloc row index for tile-rect's rows plus list's end */
+    rt_si32 rows = srf->tbx[3] - srf->tbx[1] + 1;
+
+    srf->tlr = (rt_ELEM **)alloc(sizeof(rt_ELEM *) * (rows + 1), RT_ALIGN);
+
+    /* fill marked tiles with surface data */
+    for (i = srf->tbx[1]; i <= srf->tbx[3]; i++)
+    {
+        srf->tlr[i - srf->tbx[1]] = RT_NULL;
+
         for (j = txmin[i]; j <= txmax[i]; j++)
         {
             /* alloc new element for each tile of "srf" */
@@ -2150,10 +2720,135 @@ rt_void rt_SceneThread::stile(rt_Surface *srf)
             /* insert element as list's tail */
            *ptr = elm;
             ptr = &elm->next;
+
+            /* remember row's first element */
+            if (j == txmin[i])
+            {
+                srf->tlr[i - srf->tbx[1]] = elm;
+            }
         }
     }
 
    *ptr = RT_NULL;
+
+    /* empty rows start where the next non-empty row does,
+     * so that each row's elements end at the next row's start */
+    srf->tlr[rows] = RT_NULL;
+
+    for (i = rows - 1; i >= 0; i--)
+    {
+        if (srf->tlr[i] == RT_NULL)
+        {
+            srf->tlr[i] = srf->tlr[i + 1];
+        }
+    }
+}
+
+/*
+ * Accumulate projected tile-rects of all surfaces
+ * from a given object "obj" (recursive for arrays) into "tbx",
+ * skip objects switched off by level-of-detail (not projected).
+ */
+static
+rt_void lod_tbox(rt_Object *obj, rt_si32 *tbx)
+{
+    rt_si32 i;
+
+    if (obj->lod_off != 0)
+    {
+        return;
+    }
+
+    if (RT_IS_ARRAY(obj))
+    {
+        rt_Array *arr = (rt_Array *)obj;
+
+        for (i = 0; i < arr->obj_num; i++)
+        {
+            lod_tbox(arr->obj_arr[i], tbx);
+        }
+    }
+    else
+    if (RT_IS_SURFACE(obj))
+    {
+        rt_Surface *srf = (rt_Surface *)obj;
+
+        tbx[0] = RT_MIN(tbx[0], srf->tbx[0]);
+        tbx[1] = RT_MIN(tbx[1], srf->tbx[1]);
+        tbx[2] = RT_MAX(tbx[2], srf->tbx[2]);
+        tbx[3] = RT_MAX(tbx[3], srf->tbx[3]);
+    }
+}
+
+/*
+ * Determine if object "obj" is switched off by level-of-detail
+ * selection, either directly or via any of its parents.
+ */
+static
+rt_bool lod_hidden(rt_Object *obj)
+{
+    for (; obj != RT_NULL; obj = obj->parent)
+    {
+        if (obj->lod_off != 0)
+        {
+            return RT_TRUE;
+        }
+    }
+
+    return RT_FALSE;
+}
+
+/*
+ * Select level-of-detail for a given array "arr" with alternate
+ * based on the tile-rect its surfaces occupy in the tilebuffer,
+ * as projected in "stile" of the previous update. While switched off
+ * array's contents are not projected, the alternate shown in their place
+ * is measured instead. Return non-zero if selection has changed.
+ * Full detail is kept if tiling is disabled (tile-rect is full screen).
+ */
+rt_si32 rt_SceneThread::slod(rt_Array *arr)
+{
+    rt_si32 tbx[4];
+
+    tbx[0] = scene->tiles_in_row;
+    tbx[1] = scene->tiles_in_col;
+    tbx[2] = -1;
+    tbx[3] = -1;
+
+    lod_tbox(arr->lod_off != 0 ? arr->lod_alt : arr, tbx);
+
+    /* projected size of the array's contents in pixels, contents
+     * spanning n tiles are between n-2 and n tiles in size, take n-1
+     * as tiles may be wider than the LOD sizes on wide SIMD targets */
+    rt_si32 x = RT_MAX(tbx[2] - tbx[0], 0) * scene->pfm->tile_w;
+    rt_si32 y = RT_MAX(tbx[3] - tbx[1], 0) * scene->pfm->tile_h;
+
+    /* switch back on at a larger size than switched off, as sizes
+     * are rounded to whole tiles and the alternate's extent may differ
+     * from the array's, so that the selection doesn't flip every frame */
+    rt_si32 lod_lim = arr->lod_off != 0 ? RT_LOD_SIZE_ON : RT_LOD_SIZE_OFF;
+    rt_si32 lod_off = RT_MAX(x, y) < lod_lim ? 1 : 0;
+
+    if (arr->lod_off == lod_off)
+    {
+        return 0;
+    }
+
+    arr->lod_off = lod_off;
+    arr->lod_alt->lod_off = 1 - lod_off;
+
+    /* objects switched on were skipped in update while hidden,
+     * update them in full in this frame */
+    if (lod_off != 0)
+    {
+        arr->lod_alt->lod_upd = RT_UPDATE_FLAG_OBJ;
+    }
+    else
+    {
+        arr->lod_upd = RT_UPDATE_FLAG_OBJ;
+    }
+
+    return 1;
 }
 
 /*
@@ -2213,6 +2908,12 @@ rt_ELEM* rt_SceneThread::ssort(rt_Object *obj)
         /* linear traversal across surfaces */
         for (ref = scene->srf_head; ref != RT_NULL; ref = ref->next)
         {
+            /* skip surfaces switched off by level-of-detail */
+            if (lod_hidden(ref))
+            {
+                continue;
+            }
+
             rt_ELEM tem;
 
             tem.data = 0;
@@ -2595,7 +3296,11 @@ rt_ELEM* rt_SceneThread::lsort(rt_Object *obj)
              * "bbox_shad" again if two array elements have the same bbox */
             if (prv == RT_NULL || prv->temp != box)
             {
-                s = bbox_shad(lgt->bvbox, box, srf->bvbox);
+                /* skip exact test for nodes outside of the capsule
+                 * spanned by shadow rays from the light to the surface,
+                 * which also skips contents of such arrays below */
+                s = bbox_span(lgt->bvbox, box, srf->bvbox) ? 0 :
+                    bbox_shad(lgt->bvbox, box, srf->bvbox);
             }
 
 #if RT_OPTS_2SIDED != 0
@@ -2787,6 +3492,11 @@ rt_ELEM* rt_SceneThread::lsort(rt_Object *obj)
 rt_SceneThread::~rt_SceneThread()
 {
     ASM_DONE(s_inf)
+
+    if (spare != RT_NULL)
+    {
+        delete spare;
+    }
 }
 
 /******************************************************************************/
@@ -2794,53 +3504,169 @@ rt_SceneThread::~rt_SceneThread()
 /******************************************************************************/
 
 /*
- * Allocate scene in custom heap.
- * Heap "hp" must be the same object as platform "pfm" in constructor.
+ * Count objects in the hierarchy under "obj" (including itself).
  */
-rt_pntr rt_Scene::operator new(size_t size, rt_Heap *hp)
+static
+rt_si32 count_objs(rt_Object *obj)
 {
-    return hp->obj_alloc(size, RT_ALIGN);
+    rt_si32 i, n = 1;
+
+    if (RT_IS_ARRAY(obj))
+    {
+        rt_Array *arr = (rt_Array *)obj;
+
+        for (i = 0; i < arr->obj_num; i++)
+        {
+            n += count_objs(arr->obj_arr[i]);
+        }
+    }
+
+    return n;
 }
 
 /*
- * Delete scene from custom heap.
+ * Determine if object "obj" is in the hierarchy under "top" (or is "top").
  */
-rt_void rt_Scene::operator delete(rt_pntr ptr)
+static
+rt_bool under_top(rt_Object *obj, rt_Object *top)
 {
-    ((rt_Scene *)ptr)->pfm->obj_free(ptr);
+    for (; obj != RT_NULL; obj = obj->parent)
+    {
+        if (obj == top)
+        {
+            return RT_TRUE;
+        }
+    }
+
+    return RT_FALSE;
 }
 
 /*
- * Instantiate scene.
- * Can only be called from single (main) thread.
- * Platform "pfm" must be the same object as heap "hp" in custom "new".
+ * Determine if bounds of objects in the hierarchy under array "top"
+ * (excluding itself) only contribute to boxes of arrays under "top",
+ * which depends on trnodes and bvnodes set in the current update.
+ * Such subtrees can have their bounds updated independently.
  */
-rt_Scene::rt_Scene(rt_SCENE *scn, /* "frame" must be SIMD-aligned or NULL */
-                   rt_si32 x_res, rt_si32 y_res, rt_si32 x_row, rt_ui32 *frame,
-                   rt_Platform *pfm) :
-
-    rt_Registry(pfm->f_alloc, pfm->f_free),
-    rt_List<rt_Scene>(RT_NULL)
+static
+rt_bool bounds_local(rt_Array *arr, rt_Array *top)
 {
-    this->pfm = pfm;
-
-    pfm->add_scene(this);
+    rt_si32 i;
 
-    thnum = pfm->thnum;
-    tdata = pfm->tdata;
+    for (i = 0; i < arr->obj_num; i++)
+    {
+        rt_Object *obj = arr->obj_arr[i];
 
-    thr_num = thnum; /* for registry of object hierarchy */
+        if ((obj->trnode != RT_NULL && !under_top(obj->trnode, top))
+        ||  (obj->bvnode != RT_NULL && !under_top(obj->bvnode, top)))
+        {
+            return RT_FALSE;
+        }
 
-    f_update = pfm->f_update;
-    f_render = pfm->f_render;
+        if (RT_IS_ARRAY(obj) && !bounds_local((rt_Array *)obj, top))
+        {
+            return RT_FALSE;
+        }
+    }
 
-    this->scn = scn;
+    return RT_TRUE;
+}
 
-    /* check for locked scene data, not thread safe! (it's ok, not a bug) */
-    if (scn->lock != RT_NULL)
-    {
-        throw rt_Exception("scene data is locked by another instance");
-    }
+/*
+ * Animated scene data of an object instance in subtree "task".
+ */
+struct rt_ANIM
+{
+    rt_OBJECT          *obj;
+    rt_si32             task;
+};
+
+/*
+ * Collect animated scene data from the hierarchy under "obj"
+ * into "anm" array at "num" position, tagged with subtree "task".
+ */
+static
+rt_void collect_anim(rt_Object *obj, rt_si32 task, rt_ANIM *anm, rt_si32 *num)
+{
+    rt_si32 i;
+
+    if (obj->get_anim() != RT_NULL)
+    {
+        anm[*num].obj = obj->get_anim();
+        anm[*num].task = task;
+        (*num)++;
+    }
+
+    if (RT_IS_ARRAY(obj))
+    {
+        rt_Array *arr = (rt_Array *)obj;
+
+        for (i = 0; i < arr->obj_num; i++)
+        {
+            collect_anim(arr->obj_arr[i], task, anm, num);
+        }
+    }
+}
+
+/*
+ * Compare animated scene data by address for qsort.
+ */
+static
+int cmp_anim(const void *p1, const void *p2)
+{
+    rt_ANIM *a1 = (rt_ANIM *)p1;
+    rt_ANIM *a2 = (rt_ANIM *)p2;
+
+    return a1->obj < a2->obj ? -1 : a1->obj > a2->obj ? +1 : 0;
+}
+
+/*
+ * Allocate scene in custom heap.
+ * Heap "hp" must be the same object as platform "pfm" in constructor.
+ */
+rt_pntr rt_Scene::operator new(size_t size, rt_Heap *hp)
+{
+    return hp->obj_alloc(size, RT_ALIGN);
+}
+
+/*
+ * Delete scene from custom heap.
+ */
+rt_void rt_Scene::operator delete(rt_pntr ptr)
+{
+    ((rt_Scene *)ptr)->pfm->obj_free(ptr);
+}
+
+/*
+ * Instantiate scene.
+ * Can only be called from single (main) thread.
+ * Platform "pfm" must be the same object as heap "hp" in custom "new".
+ */
+rt_Scene::rt_Scene(rt_SCENE *scn, /* "frame" must be SIMD-aligned or NULL */
+                   rt_si32 x_res, rt_si32 y_res, rt_si32 x_row, rt_ui32 *frame,
+                   rt_Platform *pfm) :
+
+    rt_Registry(pfm->f_alloc, pfm->f_free),
+    rt_List<rt_Scene>(RT_NULL)
+{
+    this->pfm = pfm;
+
+    pfm->add_scene(this);
+
+    thnum = pfm->thnum;
+    tdata = pfm->tdata;
+
+    thr_num = thnum; /* for registry of object hierarchy */
+
+    f_update = pfm->f_update;
+    f_render = pfm->f_render;
+
+    this->scn = scn;
+
+    /* check for locked scene data, not thread safe! (it's ok, not a bug) */
+    if (scn->lock != RT_NULL)
+    {
+        throw rt_Exception("scene data is locked by another instance");
+    }
 
     /* "x_row", frame's stride (in 32-bit pixels, not bytes!),
      * can be greater than "x_res", in which case the frame
@@ -2958,6 +3784,12 @@ rt_Scene::rt_Scene(rt_SCENE *scn, /* "frame" must be SIMD-aligned or NULL */
         throw rt_Exception("scene doesn't contain camera");
     }
 
+    /* allocate SIMD-buffers (with actual number of threads) */
+    if ((opts & RT_OPTS_BUFFERS) == 0)
+    {
+        alloc_buffers();
+    }
+
     cam = cam_head;
     cam_idx = 0;
 
@@ -2969,6 +3801,13 @@ rt_Scene::rt_Scene(rt_SCENE *scn, /* "frame" must be SIMD-aligned or NULL */
             alloc(sizeof(rt_SceneThread *) * thnum, RT_ALIGN);
 
     rt_si32 i;
+    rt_Light *lgt;
+
+    /* assign lights' elements in threads' occluder caches */
+    for (lgt = lgt_head, i = 0; lgt != RT_NULL; lgt = lgt->next, i++)
+    {
+        lgt->s_lgt->occ_o = i * sizeof(rt_ELEM);
+    }
 
     for (i = 0; i < thnum; i++)
     {
@@ -2983,7 +3822,63 @@ rt_Scene::rt_Scene(rt_SCENE *scn, /* "frame" must be SIMD-aligned or NULL */
             sizeof(rt_ELEM) * (srf_num + thnum - 1) / thnum; /* per thread */
     }
 
+    /* split hierarchy into subtrees for parallel phase 0.5,
+     * roughly four subtrees per thread for load balancing */
+    upd_top = RT_NULL;
+    upd_cnt = 0;
+    upd_arr = RT_NULL;
+    upd_num = 0;
+
+    rt_si32 n = count_objs(root);
+
+    if (thnum > 1 && n >= RT_UPDATE_SPLIT)
+    {
+        upd_top = (rt_Array **)alloc(sizeof(rt_Array *) * n, RT_ALIGN);
+        upd_arr = (rt_Object **)alloc(sizeof(rt_Object *) * n, RT_ALIGN);
+
+        split_tree(root, n / (thnum * 4));
+    }
+
+    /* init frame profiler */
+    reset_prof();
+
+    for (i = 0; i < RT_PROF_PHASES; i++)
+    {
+        prf_f[0][i] = -1;
+        prf_f[1][i] = -1;
+    }
+    for (i = 0; i < thnum; i++)
+    {
+        memset(tharr[i]->prf_t, 0, sizeof(rt_time) * RT_PROF_PHASES * 2);
+    }
+
+    pidx = 0;
+    ppst = 0;
+
+    /* not tuned yet */
+    t_simd = 0;
+
     pending = 0;
+    posted = 0;
+
+    /* nothing projected before the first update */
+    lod_sel = 0;
+
+    /* nothing cached before the first update */
+    cached = 0;
+    c_simd = 0;
+    c_cam = RT_NULL;
+    cpool = RT_NULL;
+
+    /* alternates are allocated in set_pipe */
+    pipe = 0;
+    flip = 0;
+    dbuf = RT_NULL;
+    dbuf_num = 0;
+    tiles_alt = RT_NULL;
+    spare = RT_NULL;
+    spool = RT_NULL;
+    sbase = 0;
 
     /* init memory pool in the heap for temporary per-frame allocs */
     mpool = RT_NULL; /* rough estimate for surface relations/templates */
@@ -2992,230 +3887,1288 @@ rt_Scene::rt_Scene(rt_SCENE *scn, /* "frame" must be SIMD-aligned or NULL */
              (srf_num + arr_num * 2 + 1) * lgt_num + /* plus array nodes */
              tiles_in_row * tiles_in_col * arr_num) *  /* for tiling */
             sizeof(rt_ELEM);                        /* for main thread */
+    mbase = 0;
+    mpeak = 0;
+    mfrms = 0;
 
     /* in the estimates above ("arr_num" * x) depends on whether both
      * trnode/bvnode are allowed in the list or just one of them,
      * if the estimates are not accurate the engine should still work,
      * though not as efficient due to unnecessary allocations per frame
      * or unused extra memory reservation resulting in larger footprint */
+
+    /* SIMD-buffers scale with nodes x threads, warn if excessive */
+    if (get_bsize() >= (rt_size)RT_BUFFER_WARN * 1024 * 1024)
+    {
+        RT_LOGI("SIMD-buffers take %ld MB (%d nodes x %d threads)\n",
+                (long)(get_bsize() / (1024 * 1024)), arr_num + srf_num,
+                                                                    thnum);
+    }
 }
 
 /*
- * Update current camera with given "action" for a given "time".
+ * Adapt per-frame pool size "msize" of heap "hp" to its actual usage
+ * since the pool was reserved at "mbase" live bytes. Pools that overflowed
+ * grow at once with headroom, thus the next reserve pre-grows the heap
+ * in a single chunk which is then reused across frames. Pools used
+ * less than half shrink to their high-water at the end of a window.
  */
-rt_void rt_Scene::update(rt_time time, rt_si32 action)
+static
+rt_void adapt_pool(rt_Heap *hp, rt_size mbase,
+                   rt_ui32 *msize, rt_ui32 *mpeak, rt_bool wend)
 {
-    cam->update_action(time, action);
+    rt_MSTAT mst;
+
+    /* per-frame allocs are linear, thus live bytes are the high-water */
+    hp->get_mstat(&mst);
+
+    rt_ui32 used = (rt_ui32)(mst.live > mbase ? mst.live - mbase : 0);
+
+    *mpeak = RT_MAX(*mpeak, used);
+
+    if (used > *msize)
+    {
+        *msize = used + used / 4;
+    }
+    else
+    if (wend && *mpeak + *mpeak / 4 < *msize / 2)
+    {
+        *msize = *mpeak + *mpeak / 4;
+    }
+
+    if (wend)
+    {
+        *mpeak = 0;
+    }
 }
 
 /*
- * Update backend data structures and render frame for a given "time".
+ * Reserve memory pools for temporary per-frame allocs
+ * in scene's and threads' heaps, reset heaps' per-frame high-water.
  */
-rt_void rt_Scene::render(rt_time time)
+rt_void rt_Scene::reserve_pools()
 {
+    rt_MSTAT mst;
     rt_si32 i;
 
-#if RT_OPTS_UPDATE_EXT0 != 0
-    if ((opts & RT_OPTS_UPDATE_EXT0) == 0 || rootobj.time == -1)
-    { /* -->---->-- skip update1 -->---->-- */
-#endif /* RT_OPTS_UPDATE_EXT0 */
+    rt_Heap::get_mstat(&mst);
+    mbase = mst.live;
+    reset_mstat();
+    mpool = reserve(msize, RT_QUAD_ALIGN);
 
-    if (pending)
+    for (i = 0; i < thnum; i++)
     {
-        pending = 0;
+        tharr[i]->get_mstat(&mst);
+        tharr[i]->mbase = mst.live;
+        tharr[i]->reset_mstat();
+        tharr[i]->mpool = tharr[i]->reserve(tharr[i]->msize, RT_QUAD_ALIGN);
+    }
+}
 
-        /* release memory for temporary per-frame allocs */
-        for (i = 0; i < thnum; i++)
-        {
-            tharr[i]->release(tharr[i]->mpool);
-        }
+/*
+ * Release memory pools for temporary per-frame allocs,
+ * adapt pools' sizes to the high-water of previous frames.
+ */
+rt_void rt_Scene::release_pools()
+{
+    rt_si32 i;
+    rt_bool wend = ++mfrms >= RT_POOL_FRAMES;
+
+    mfrms = wend ? 0 : mfrms;
 
-        release(mpool);
+    for (i = 0; i < thnum; i++)
+    {
+        adapt_pool(tharr[i], tharr[i]->mbase,
+                   &tharr[i]->msize, &tharr[i]->mpeak, wend);
+        tharr[i]->release(tharr[i]->mpool);
     }
 
-    /* reserve memory for temporary per-frame allocs */
-    mpool = reserve(msize, RT_QUAD_ALIGN);
+    adapt_pool(this, mbase, &msize, &mpeak, wend);
+    release(mpool);
+}
+
+/*
+ * Exchange per-frame heaps (with their memory pools)
+ * of the scene and its threads with their spare heaps.
+ */
+rt_void rt_Scene::swap_pools()
+{
+    rt_pntr pool;
+    rt_size base;
+    rt_si32 i;
 
     for (i = 0; i < thnum; i++)
     {
-        tharr[i]->mpool = tharr[i]->reserve(tharr[i]->msize, RT_QUAD_ALIGN);
+        rt_SceneThread *thr = tharr[i];
+
+        thr->swap(thr->spare);
+
+        pool = thr->mpool;
+        thr->mpool = thr->spool;
+        thr->spool = pool;
+
+        base = thr->mbase;
+        thr->mbase = thr->sbase;
+        thr->sbase = base;
     }
 
-    /* print state init */
-    if (g_print)
+    rt_Heap::swap(spare);
+
+    pool = mpool;
+    mpool = spool;
+    spool = pool;
+
+    base = mbase;
+    mbase = sbase;
+    sbase = base;
+}
+
+/*
+ * Restore pointers of surface struct "s_srf" to itself
+ * and to its "trnode's" struct after double-buffers' flip.
+ */
+static
+rt_void flip_simd(rt_SIMD_SURFACE *s_srf, rt_Object *trnode)
+{
+    rt_ui64 ptr = (rt_ui64)(rt_uptr)s_srf;
+
+    if (s_srf->srf_p[0] != 0 || s_srf->srf_h[0] != 0)
     {
-        RT_PRINT_STATE_INIT();
-        RT_PRINT_TIME(time);
+        RT_SIMD_SET(s_srf->srf_p, (rt_uelm)(ptr & 0xFFFFFFFF));
+        RT_SIMD_SET(s_srf->srf_h, (rt_uelm)(ptr >> 32));
     }
 
-    /* phase 0.5, hierarchical update of arrays' transform matrices */
-    root->update_object(time, 0, RT_NULL, iden4);
-
-    if (pt_on && (root->scn_changed || pfm->fsaa != fsaa))
+    if (s_srf->msc_p[3] != RT_NULL && trnode != RT_NULL)
     {
-        reset_color();
+        s_srf->msc_p[3] = ((rt_Node *)trnode)->s_srf;
     }
+}
 
-    /* update current antialiasing mode per scene */
-    fsaa = pfm->fsaa;
+/*
+ * Switch backend structs, tilebuffer and per-frame heaps to their
+ * alternates before the next frame is prepared in pipelined mode,
+ * the frame in flight keeps rendering from the previous ones.
+ */
+rt_void rt_Scene::flip_pipe()
+{
+    rt_si32 i;
 
-    /* 1st phase of multi-threaded update */
-#if RT_OPTS_THREAD != 0
-    if ((opts & RT_OPTS_THREAD) != 0 && this == pfm->get_cur_scene() && !g_print
-#if RT_OPTS_UPDATE_EXT1 != 0
-    &&  (opts & RT_OPTS_UPDATE_EXT1) == 0
-#endif /* RT_OPTS_UPDATE_EXT1 */
-       )
+    /* update only rewrites changed objects' fields,
+     * thus alternates start as copies of current structs */
+    for (i = 0; i < dbuf_num; i++)
     {
-        this->f_update(tdata, thnum, 1);
+        rt_pntr ptr = *dbuf[i].ptr;
+
+        memcpy(dbuf[i].alt, ptr, dbuf[i].size);
+
+       *dbuf[i].ptr = dbuf[i].alt;
+        dbuf[i].alt = ptr;
     }
-    else
-#endif /* RT_OPTS_THREAD */
+
+    rt_Array *arr;
+
+    for (arr = arr_head; arr != RT_NULL; arr = arr->next)
     {
-        update_scene(this, -thnum, 1);
+        flip_simd(arr->s_srf, arr->trnode);
+        flip_simd(arr->s_inb, arr->trnode);
+        flip_simd(arr->s_bvb, arr->trnode);
     }
 
-    /* update ray positioning and steppers */
-    rt_real h, v;
+    rt_Surface *srf;
+    rt_ELEM *elm;
 
-    RT_VEC3_SET(pos, cam->pos);
-    RT_VEC3_SET(hor, cam->hor);
-    RT_VEC3_SET(ver, cam->ver);
-    RT_VEC3_SET(nrm, cam->nrm);
+    for (srf = srf_head; srf != RT_NULL; srf = srf->next)
+    {
+        flip_simd(srf->s_srf, srf->trnode);
 
-    h = -0.5f * 1.0f;
-    v = -0.5f * aspect;
+        /* custom clippers list is built via shape's pointer */
+        srf->shape->ptr = (rt_pntr *)&srf->s_srf->msc_p[2];
 
-    /* aim rays at camera's top-left corner */
-    RT_VEC3_MUL_VAL1(dir, nrm, cam->pov);
-    RT_VEC3_MAD_VAL1(dir, hor, h);
-    RT_VEC3_MAD_VAL1(dir, ver, v);
+        /* surface elements in relations template */
+        for (elm = srf->rel; elm != RT_NULL; elm = elm->next)
+        {
+            if (elm->simd != RT_NULL)
+            {
+                elm->simd = ((rt_Node *)((rt_BOUND *)elm->temp)->obj)->s_srf;
+            }
+        }
+    }
 
-    /* update tile positioning and steppers */
-    RT_VEC3_ADD(org, pos, dir);
+    rt_ELEM **tls = tiles;
+    tiles = tiles_alt;
+    tiles_alt = tls;
 
-    h = 1.0f / (factor * pfm->tile_w); /* x_res / tile_w */
-    v = 1.0f / (factor * pfm->tile_h); /* x_res / tile_h */
+    /* frame in flight's pools go to spare heaps */
+    swap_pools();
 
-    RT_VEC3_MUL_VAL1(htl, hor, h);
-    RT_VEC3_MUL_VAL1(vtl, ver, v);
+    /* frame in flight keeps its profiler times */
+    pidx ^= 1;
 
-    /* 2nd phase of multi-threaded update */
+    flip = 1;
+}
+
+/*
+ * Run given update "phase" on the thread pool if allowed,
+ * otherwise run all of its slices sequentially on this thread.
+ */
+rt_void rt_Scene::update_mt(rt_si32 phase)
+{
 #if RT_OPTS_THREAD != 0
-    if ((opts & RT_OPTS_THREAD) != 0 && this == pfm->get_cur_scene() && !g_print
-#if RT_OPTS_UPDATE_EXT2 != 0
-    &&  (opts & RT_OPTS_UPDATE_EXT2) == 0
-#endif /* RT_OPTS_UPDATE_EXT2 */
-       )
+    if ((opts & RT_OPTS_THREAD) != 0 && !g_print && !posted
+    &&  this == pfm->get_cur_scene())
     {
-        this->f_update(tdata, thnum, 2);
+        this->f_update(tdata, thnum, phase);
     }
     else
 #endif /* RT_OPTS_THREAD */
     {
-        update_scene(this, -thnum, 2);
+        update_scene(this, -thnum, phase);
     }
+}
 
-    /* phase 2.5, hierarchical update of arrays' bounds from surfaces */
-    root->update_bounds();
+/*
+ * Split hierarchy under array "arr" into subtrees of at most "size" objects
+ * updated in parallel phase 0.5, arrays with bigger subtrees are updated
+ * sequentially before them. Animator is called once for object instances
+ * sharing the same scene data, therefore if such instances end up
+ * in different subtrees the split is dropped (sequential update).
+ */
+rt_void rt_Scene::split_tree(rt_Array *arr, rt_si32 size)
+{
+    rt_si32 i;
 
-    rt_Surface *srf;
+    upd_top[upd_cnt++] = arr;
 
-    /* update surfaces' node lists */
-    for (srf = srf_head; srf != RT_NULL; srf = srf->next)
+    for (i = 0; i < arr->obj_num; i++)
     {
-        /* rebuild surface's node list (per-surface)
-         * based on transform flags and arrays' bounds */
-        tharr[0]->snode(srf);
+        rt_Object *obj = arr->obj_arr[i];
+
+        if (RT_IS_ARRAY(obj) && count_objs(obj) > size)
+        {
+            split_tree((rt_Array *)obj, size);
+        }
+        else
+        {
+            upd_arr[upd_num++] = obj;
+        }
     }
 
-    /* rebuild global hierarchical list */
-    hlist = tharr[0]->ssort(RT_NULL);
+    if (arr != root)
+    {
+        return;
+    }
 
-    /* rebuild global surface/node list */
-    slist = tharr[0]->ssort(RT_NULL);
-    tharr[0]->filter(RT_NULL, &slist);
+    /* temporary array is released right away */
+    rt_pntr mark = reserve(0, RT_ALIGN);
+    rt_ANIM *anm = (rt_ANIM *)
+            alloc(sizeof(rt_ANIM) * count_objs(root), RT_ALIGN);
+    rt_si32 num = 0;
 
-    /* rebuild global light/shadow list,
-     * "slist" is needed inside */
-    llist = tharr[0]->lsort(RT_NULL);
+    for (i = 0; i < upd_num; i++)
+    {
+        collect_anim(upd_arr[i], i, anm, &num);
+    }
 
-    /* rebuild camera's surface/node list,
-     * "slist" is needed inside */
-    clist = tharr[0]->ssort(cam);
+    qsort(anm, num, sizeof(rt_ANIM), cmp_anim);
 
-    if (g_print)
+    for (i = 1; i < num; i++)
     {
-        RT_PRINT_GLB();
-        RT_PRINT_SRF_LST(slist);
-        RT_PRINT_LGT_LST(llist);
-        RT_PRINT_CAM(cam);
+        if (anm[i].obj == anm[i - 1].obj && anm[i].task != anm[i - 1].task)
+        {
+            upd_cnt = 0;
+            upd_num = 0;
+            break;
+        }
+    }
+
+    release(mark);
+}
+
+/*
+ * Hierarchical update of arrays' transform matrices (phase 0.5)
+ * for a given "time", subtrees from "split_tree" are updated in parallel
+ * once arrays above them are updated, changed status is then propagated
+ * back from subtrees to the root.
+ */
+rt_void rt_Scene::update_tree(rt_time time)
+{
+    rt_si32 i;
+
+    if (upd_num == 0)
+    {
+        root->update_object(time, 0, RT_NULL, iden4);
+        return;
+    }
+
+    for (i = 0; i < upd_cnt; i++)
+    {
+        upd_top[i]->update_array(time);
+    }
+
+    update_mt(0);
+
+    for (i = upd_cnt - 1; i >= 0; i--)
+    {
+        upd_top[i]->update_changed();
+    }
+}
+
+/*
+ * Update current camera with given "action" for a given "time".
+ */
+rt_void rt_Scene::update(rt_time time, rt_si32 action)
+{
+    cam->update_action(time, action);
+}
+
+/*
+ * Update backend data structures and render frame for a given "time".
+ */
+rt_void rt_Scene::render(rt_time time)
+{
+    prepare(time);
+    render_post();
+    render_wait();
+}
+
+/*
+ * Update backend data structures for a given "time", the frame
+ * is then rendered by "render_post" followed by "render_wait".
+ * In pipelined mode (see set_pipe) this can be called while
+ * the previous frame is still being rendered by worker-threads.
+ */
+rt_void rt_Scene::prepare(rt_time time)
+{
+    rt_si32 i;
+
+    /* frame in flight is only overlapped in pipelined mode,
+     * unless its state is shared with the frame being prepared */
+    if (posted && (pipe == 0 || pt_on || g_print
+    ||  (opts & RT_OPTS_UPDATE_EXT0) != 0
+    ||  (pfm->t_frms > 0 && pfm->t_scn != this)))
+    {
+        render_wait();
+    }
+
+    /* pick SIMD target on first render after scene change,
+     * tuning renders the scene itself, thus t_scn is set first */
+    if (pfm->t_frms > 0 && pfm->t_scn != this)
+    {
+        pfm->t_scn = this;
+
+        if (t_simd == 0)
+        {
+            t_simd = tune_simd(time, pfm->t_frms);
+        }
+        else
+        {
+            t_simd = pfm->set_simd(t_simd);
+        }
+    }
+
+    /* bind heaps to main thread's trace ring (RT_NULL - off),
+     * per-frame reserve/release is done on the main thread */
+    trace = pfm->get_trace(0);
+    for (i = 0; i < thnum; i++)
+    {
+        tharr[i]->trace = trace;
+    }
+
+    tprf = get_usec();
+
+    /* switch to alternate buffers and heaps,
+     * frame in flight keeps the previous ones */
+    if (posted)
+    {
+        flip_pipe();
+    }
+    else
+    {
+        tfrm = tprf;
+    }
+
+#if RT_OPTS_UPDATE_EXT0 != 0
+    if ((opts & RT_OPTS_UPDATE_EXT0) == 0 || rootobj.time == -1)
+    { /* -->---->-- skip update1 -->---->-- */
+#endif /* RT_OPTS_UPDATE_EXT0 */
+
+    /* print state init */
+    if (g_print)
+    {
+        RT_PRINT_STATE_INIT();
+        RT_PRINT_TIME(time);
+    }
+
+    rt_Array *arr;
+
+    /* select arrays' level-of-detail based on surfaces' tile-rects
+     * projected in the previous update, switched off subtrees are
+     * skipped in phases 1/2 while switched on ones are updated in full */
+    for (arr = arr_head; arr != RT_NULL && lod_sel; arr = arr->next)
+    {
+        if (arr->lod_alt != RT_NULL
+        &&  tharr[0]->slod(arr) && pt_on)
+        {
+            reset_color();
+        }
+    }
+
+    /* phase 0.5, hierarchical update of arrays' transform matrices */
+    update_tree(time);
+
+    tprf = stamp_prof(RT_PROF_UPDATE_05, tprf);
+
+    if (pt_on && (root->scn_changed || pfm->fsaa != fsaa))
+    {
+        reset_color();
+    }
+
+    /* static scene reuses per-frame lists of the last update,
+     * if cameras changed only their dependent data is rebuilt */
+    rt_si32 reuse = check_cache();
+
+    if (reuse == 1)
+    {
+        /* release camera-dependent allocs of the previous
+         * static frame, the rest of per-frame pools is kept */
+        if (cpool != RT_NULL)
+        {
+            release(cpool);
+
+            for (i = 0; i < thnum; i++)
+            {
+                tharr[i]->release(tharr[i]->cpool);
+            }
+        }
+
+        cpool = reserve(0, RT_QUAD_ALIGN);
+
+        for (i = 0; i < thnum; i++)
+        {
+            tharr[i]->cpool = tharr[i]->reserve(0, RT_QUAD_ALIGN);
+        }
+
+        rt_Camera *cmr;
+
+        /* update fields of changed cameras (as in 1st phase) */
+        for (cmr = cam_head; cmr != RT_NULL; cmr = cmr->next)
+        {
+            cmr->update_fields();
+        }
+
+        update_cam();
+        c_cam = cam;
+
+        tprf = stamp_prof(RT_PROF_TILING, tprf);
+    }
+
+    if (reuse > 0)
+    {
+        return;
+    }
+
+    cached = 0;
+    c_cam = RT_NULL;
+    cpool = RT_NULL;
+
+    if (pending)
+    {
+        pending = 0;
+
+        /* release memory for temporary per-frame allocs */
+        release_pools();
+    }
+
+    /* reserve memory for temporary per-frame allocs */
+    reserve_pools();
+
+    /* update current antialiasing mode per scene */
+    fsaa = pfm->fsaa;
+
+    /* 1st phase of multi-threaded update */
+#if RT_OPTS_THREAD != 0
+    if ((opts & RT_OPTS_THREAD) != 0 && this == pfm->get_cur_scene() && !g_print
+    &&  !posted /* thread pool is busy rendering the frame in flight */
+#if RT_OPTS_UPDATE_EXT1 != 0
+    &&  (opts & RT_OPTS_UPDATE_EXT1) == 0
+#endif /* RT_OPTS_UPDATE_EXT1 */
+       )
+    {
+        this->f_update(tdata, thnum, 1);
+    }
+    else
+#endif /* RT_OPTS_THREAD */
+    {
+        update_scene(this, -thnum, 1);
+    }
+
+    tprf = stamp_prof(RT_PROF_UPDATE_1, tprf);
+
+    /* update ray positioning and steppers */
+    update_view();
+
+    /* 2nd phase of multi-threaded update */
+#if RT_OPTS_THREAD != 0
+    if ((opts & RT_OPTS_THREAD) != 0 && this == pfm->get_cur_scene() && !g_print
+    &&  !posted
+#if RT_OPTS_UPDATE_EXT2 != 0
+    &&  (opts & RT_OPTS_UPDATE_EXT2) == 0
+#endif /* RT_OPTS_UPDATE_EXT2 */
+       )
+    {
+        this->f_update(tdata, thnum, 2);
+    }
+    else
+#endif /* RT_OPTS_THREAD */
+    {
+        update_scene(this, -thnum, 2);
+    }
+
+    tprf = stamp_prof(RT_PROF_UPDATE_2, tprf);
+
+    /* surfaces' tile-rects are projected in 2nd phase */
+    lod_sel = 1;
+
+    /* phase 2.5, hierarchical update of arrays' bounds from surfaces,
+     * subtrees from "split_tree" with local bounds are updated in parallel,
+     * then arrays above them sequentially (skipping updated subtrees) */
+    if (upd_num != 0)
+    {
+        update_mt(9);
+    }
+
+    root->update_bounds();
+
+    /* update surfaces' node lists (per-surface) */
+    update_mt(4);
+
+    /* rebuild global hierarchical and surface/node lists */
+    update_mt(5);
+
+    /* rebuild global light/shadow and camera's surface/node lists,
+     * "slist" from the previous phase is needed inside both */
+    update_mt(6);
+
+    if (g_print)
+    {
+        RT_PRINT_GLB();
+        RT_PRINT_SRF_LST(slist);
+        RT_PRINT_LGT_LST(llist);
+        RT_PRINT_CAM(cam);
         RT_PRINT_SRF_LST(clist);
     }
 
-    /* 3rd phase of multi-threaded update */
-#if RT_OPTS_THREAD != 0
-    if ((opts & RT_OPTS_THREAD) != 0 && this == pfm->get_cur_scene() && !g_print
-#if RT_OPTS_UPDATE_EXT3 != 0
-    &&  (opts & RT_OPTS_UPDATE_EXT3) == 0
-#endif /* RT_OPTS_UPDATE_EXT3 */
-       )
+    tprf = stamp_prof(RT_PROF_UPDATE_25, tprf);
+
+    /* 3rd phase of multi-threaded update */
+#if RT_OPTS_THREAD != 0
+    if ((opts & RT_OPTS_THREAD) != 0 && this == pfm->get_cur_scene() && !g_print
+    &&  !posted
+#if RT_OPTS_UPDATE_EXT3 != 0
+    &&  (opts & RT_OPTS_UPDATE_EXT3) == 0
+#endif /* RT_OPTS_UPDATE_EXT3 */
+       )
+    {
+        this->f_update(tdata, thnum, 3);
+    }
+    else
+#endif /* RT_OPTS_THREAD */
+    {
+        update_scene(this, -thnum, 3);
+    }
+
+    tprf = stamp_prof(RT_PROF_UPDATE_3, tprf);
+
+    /* screen tiling, aim rays and ambient */
+    update_tiles();
+
+    tprf = stamp_prof(RT_PROF_TILING, tprf);
+
+    /* keep per-frame lists for the next static frames,
+     * pipelined mode flips them with every frame instead */
+#if RT_OPTS_STATIC != 0
+    if ((opts & RT_OPTS_STATIC) != 0 && pipe == 0 && !g_print)
+    {
+        cached = 1;
+        c_simd = pfm->get_simd();
+        c_cam = cam;
+    }
+#endif /* RT_OPTS_STATIC */
+
+#if RT_OPTS_UPDATE_EXT0 != 0
+    } /* --<----<-- skip update1 --<----<-- */
+#endif /* RT_OPTS_UPDATE_EXT0 */
+}
+
+/*
+ * Update ray positioning and tile steppers from current camera.
+ */
+rt_void rt_Scene::update_view()
+{
+    rt_real h, v;
+
+    RT_VEC3_SET(pos, cam->pos);
+    RT_VEC3_SET(hor, cam->hor);
+    RT_VEC3_SET(ver, cam->ver);
+    RT_VEC3_SET(nrm, cam->nrm);
+
+    h = -0.5f * 1.0f;
+    v = -0.5f * aspect;
+
+    /* aim rays at camera's top-left corner */
+    RT_VEC3_MUL_VAL1(dir, nrm, cam->pov);
+    RT_VEC3_MAD_VAL1(dir, hor, h);
+    RT_VEC3_MAD_VAL1(dir, ver, v);
+
+    /* update tile positioning and steppers */
+    RT_VEC3_ADD(org, pos, dir);
+
+    h = 1.0f / (factor * pfm->tile_w); /* x_res / tile_w */
+    v = 1.0f / (factor * pfm->tile_h); /* x_res / tile_h */
+
+    RT_VEC3_MUL_VAL1(htl, hor, h);
+    RT_VEC3_MUL_VAL1(vtl, ver, v);
+}
+
+/*
+ * Build screen tiling from surfaces' tile lists and camera's surface list,
+ * then aim rays at pixel centers and accumulate ambient from current camera.
+ */
+rt_void rt_Scene::update_tiles()
+{
+    rt_si32 i, j, tline;
+
+#if RT_OPTS_TILING != 0
+    if ((opts & RT_OPTS_TILING) != 0)
+    {
+        rt_ELEM *elm, *nxt, **ptr = &ctail;
+
+        ctail = RT_NULL;
+
+        /* build exact copy of reversed "clist" (should be cheap),
+         * trnode elements become tailing rather than heading,
+         * elements grouping for cached transform is retained */
+        for (nxt = clist; nxt != RT_NULL; nxt = nxt->next)
+        {
+            /* alloc new element as "nxt's" copy */
+            elm = (rt_ELEM *)alloc(sizeof(rt_ELEM), RT_QUAD_ALIGN);
+            elm->data = nxt->data;
+            elm->simd = nxt->simd;
+            elm->temp = nxt->temp;
+            /* insert element as list's head */
+            elm->next = *ptr;
+           *ptr = elm;
+        }
+
+        /* merge surfaces' tile lists into tilebuffer by rows */
+        update_mt(7);
+
+        if (g_print)
+        {
+            rt_si32 i = 0, j = 0;
+
+            tline = i * tiles_in_row;
+
+            RT_PRINT_TLS_LST(tiles[tline + j], i, j);
+        }
+    }
+    else
+#endif /* RT_OPTS_TILING */
+    {
+        for (i = 0; i < tiles_in_col; i++)
+        {
+            tline = i * tiles_in_row;
+
+            for (j = 0; j < tiles_in_row; j++)
+            {
+                tiles[tline + j] = clist;
+            }
+        }
+    }
+
+    /* aim rays at pixel centers */
+    RT_VEC3_MUL_VAL1(hor, hor, factor);
+    RT_VEC3_MUL_VAL1(ver, ver, factor);
+
+    RT_VEC3_MAD_VAL1(dir, hor, 0.5f);
+    RT_VEC3_MAD_VAL1(dir, ver, 0.5f);
+
+    /* accumulate ambient from camera and all light sources */
+    RT_VEC3_MUL_VAL1(amb, cam->cam->col.hdr, cam->cam->lum[0]);
+    amb[RT_A] = cam->cam->lum[0];
+
+    rt_Light *lgt = RT_NULL;
+
+    for (lgt = lgt_head; lgt != RT_NULL; lgt = lgt->next)
+    {
+        RT_VEC3_MAD_VAL1(amb, lgt->lgt->col.hdr, lgt->lgt->lum[0]);
+        amb[RT_A] += lgt->lgt->lum[0];
+    }
+}
+
+/*
+ * Rebuild camera-dependent data of the frame with the rest of
+ * the scene kept from the last update: ray steppers, surfaces'
+ * tile lists, camera's surface list and screen tiling.
+ */
+rt_void rt_Scene::update_cam()
+{
+    update_view();
+
+    /* rebuild surfaces' tile lists from the new view */
+    update_mt(8);
+
+    /* rebuild camera's surface/node list */
+    clist = tharr[0]->ssort(cam);
+
+    update_tiles();
+}
+
+/*
+ * Check if per-frame lists kept from the last update are still valid
+ * once phase 0.5 has updated objects' changed status. Return 0 if full
+ * update is needed, 1 if only camera-dependent data is to be rebuilt,
+ * 2 if the frame's state is reused as is.
+ */
+rt_si32 rt_Scene::check_cache()
+{
+    rt_Array   *arr;
+    rt_Camera  *cam;
+    rt_Light   *lgt;
+    rt_Surface *srf;
+
+    if (cached == 0 || g_print
+    ||  fsaa != pfm->fsaa || c_simd != pfm->get_simd())
+    {
+        return 0;
+    }
+
+    for (arr = arr_head; arr != RT_NULL; arr = arr->next)
+    {
+        if (arr->obj_changed)
+        {
+            return 0;
+        }
+    }
+
+    for (lgt = lgt_head; lgt != RT_NULL; lgt = lgt->next)
+    {
+        if (lgt->obj_changed)
+        {
+            return 0;
+        }
+    }
+
+    for (srf = srf_head; srf != RT_NULL; srf = srf->next)
+    {
+        if (srf->obj_changed)
+        {
+            return 0;
+        }
+    }
+
+    rt_si32 reuse = this->cam == c_cam ? 2 : 1;
+
+    for (cam = cam_head; cam != RT_NULL; cam = cam->next)
+    {
+        if (cam->obj_changed)
+        {
+            reuse = 1;
+        }
+    }
+
+    return reuse;
+}
+
+/*
+ * Start rendering the frame prepared by "prepare". On the current scene
+ * render is started on the platform's thread pool, returning right away
+ * if the platform supports RT_RENDER_POST, otherwise it completes here.
+ */
+rt_void rt_Scene::render_post()
+{
+    rt_si32 mode = render_init();
+
+    /* multi-threaded render */
+    if (mode > 0)
+    {
+        this->f_render(tdata, thnum, RT_RENDER_POST | 1);
+        posted = 2;
+    }
+    else
+    if (mode == 0)
+    {
+        render_scene(this, -thnum, 1);
+    }
+}
+
+/*
+ * Mark the frame prepared by "prepare" as posted and fill in
+ * threads' backend structures from its state. Return 1 if the frame
+ * can be rendered on the platform's thread pool, 0 if on main thread,
+ * -1 if rendering is skipped (RT_OPTS_RENDER_EXT0).
+ */
+rt_si32 rt_Scene::render_init()
+{
+    rt_si32 i;
+
+    posted = 1;
+
+    /* render's profiler times go with the frame */
+    ppst = pidx;
+
+#if RT_FEAT_COUNTERS
+
+    /* reset backend's hot-path counters for current frame */
+    for (i = 0; i < thnum; i++)
+    {
+        memset(&tharr[i]->s_inf->cnt_pri, 0, sizeof(rt_word) * RT_CNT_TOTAL);
+        memset(tharr[i]->s_inf->cnt_lnr, 0, sizeof(rt_uelm) * S);
+        memset(tharr[i]->s_inf->cnt_lnc, 0, sizeof(rt_uelm) * S);
+    }
+
+#endif /* RT_FEAT_COUNTERS */
+
+    trnd = get_usec();
+
+#if RT_OPTS_RENDER_EXT0 != 0
+    if ((opts & RT_OPTS_RENDER_EXT0) != 0)
+    {
+        return -1;
+    }
+#endif /* RT_OPTS_RENDER_EXT0 */
+
+    /* fill in threads' backend structures from the frame's state here,
+     * as in pipelined mode the state is changed by the next "prepare"
+     * while worker-threads are still rendering */
+    for (i = 0; i < thnum; i++)
+    {
+/*  rt_SIMD_CAMERA */
+
+        rt_SIMD_CAMERA *s_cam = tharr[i]->s_cam;
+
+        RT_SIMD_SET(s_cam->t_max, RT_INF);
+
+        RT_SIMD_SET(s_cam->dir_x, dir[RT_X]);
+        RT_SIMD_SET(s_cam->dir_y, dir[RT_Y]);
+        RT_SIMD_SET(s_cam->dir_z, dir[RT_Z]);
+
+        RT_SIMD_SET(s_cam->hor_x, hor[RT_X]);
+        RT_SIMD_SET(s_cam->hor_y, hor[RT_Y]);
+        RT_SIMD_SET(s_cam->hor_z, hor[RT_Z]);
+
+        RT_SIMD_SET(s_cam->ver_x, ver[RT_X]);
+        RT_SIMD_SET(s_cam->ver_y, ver[RT_Y]);
+        RT_SIMD_SET(s_cam->ver_z, ver[RT_Z]);
+
+        RT_SIMD_SET(s_cam->clamp, (rt_real)255);
+        RT_SIMD_SET(s_cam->cmask, (rt_elem)255);
+
+        RT_SIMD_SET(s_cam->col_r, amb[RT_R]);
+        RT_SIMD_SET(s_cam->col_g, amb[RT_G]);
+        RT_SIMD_SET(s_cam->col_b, amb[RT_B]);
+        RT_SIMD_SET(s_cam->l_amb, amb[RT_A]);
+
+/*  rt_SIMD_CONTEXT */
+
+        rt_SIMD_CONTEXT *s_ctx = tharr[i]->s_ctx;
+
+        s_ctx->param[1] = -((opts & RT_OPTS_GAMMA) == 0) & RT_PROP_GAMMA;
+        RT_SIMD_SET(s_ctx->t_min, cam->pov);
+
+        RT_SIMD_SET(s_ctx->org_x, pos[RT_X]);
+        RT_SIMD_SET(s_ctx->org_y, pos[RT_Y]);
+        RT_SIMD_SET(s_ctx->org_z, pos[RT_Z]);
+
+/*  rt_SIMD_INFOX */
+
+        rt_SIMD_INFOX *s_inf = tharr[i]->s_inf;
+
+        s_inf->ctx = s_ctx;
+        s_inf->cam = s_cam;
+        s_inf->lst = clist;
+
+        s_inf->tiles = tiles;
+        s_inf->frame = frame;
+
+        s_inf->depth = depth;
+        s_inf->pt_on = pt_on;
+
+        RT_SIMD_SET(s_inf->pts_c, pts_c);
+    }
+
+#if 0 /* SIMD-buffers don't normally require reset between frames */
+    reset_color();
+#endif /* enable for SIMD-buffers as a debug option if needed */
+
+    /* multi-threaded render */
+#if RT_OPTS_THREAD != 0
+    if ((opts & RT_OPTS_THREAD) != 0 && this == pfm->get_cur_scene()
+#if RT_OPTS_RENDER_EXT1 != 0
+    &&  (opts & RT_OPTS_RENDER_EXT1) == 0
+#endif /* RT_OPTS_RENDER_EXT1 */
+       )
+    {
+        return 1;
+    }
+#endif /* RT_OPTS_THREAD */
+
+    return 0;
+}
+
+/*
+ * Wait for the frame started by "render_post" to finish rendering,
+ * then release per-frame memory and merge profiler statistics.
+ */
+rt_void rt_Scene::render_wait()
+{
+    rt_si32 i;
+
+    /* nothing to wait for */
+    if (posted == 0)
+    {
+        return;
+    }
+
+#if RT_OPTS_RENDER_EXT0 != 0
+    if ((opts & RT_OPTS_RENDER_EXT0) == 0)
+    { /* -->---->-- skip render0 -->---->-- */
+#endif /* RT_OPTS_RENDER_EXT0 */
+
+    if (posted == 2)
+    {
+        /* wait for all worker-threads to finish */
+        this->f_render(tdata, thnum, RT_RENDER_WAIT);
+    }
+
+    stamp_prof(RT_PROF_RENDER, trnd);
+
+    pts_c = tharr[0]->s_inf->pts_c[0];
+
+#if RT_OPTS_RENDER_EXT0 != 0
+    } /* --<----<-- skip render0 --<----<-- */
+#endif /* RT_OPTS_RENDER_EXT0 */
+
+
+#if RT_OPTS_UPDATE_EXT0 != 0
+    if ((opts & RT_OPTS_UPDATE_EXT0) == 0)
+    { /* -->---->-- skip update2 -->---->-- */
+#endif /* RT_OPTS_UPDATE_EXT0 */
+
+    /* print state done */
+    if (g_print)
+    {
+        rt_MSTAT mst;
+        rt_char name[24];
+
+        RT_PRINT_MEM_INIT();
+        get_mstat(-1, &mst);
+        print_mem("    ", "scene", &mst, msize);
+
+        for (i = 0; i < thnum; i++)
+        {
+            snprintf(name, sizeof(name), "thread %d", i);
+            get_mstat(i, &mst);
+            print_mem("    ", name, &mst, tharr[i]->msize);
+        }
+
+        RT_LOGI("    SIMD-buffers: %ld (%d nodes x %d threads)\n",
+                        (long)get_bsize(), arr_num + srf_num, thnum);
+        RT_LOGI("\n");
+
+        RT_PRINT_STATE_DONE();
+        g_print = RT_FALSE;
+    }
+
+    /* release memory for temporary per-frame allocs,
+     * frame in flight has them in spare heaps if flipped */
+    if (flip)
+    {
+        flip = 0;
+
+        swap_pools();
+        release_pools();
+        swap_pools();
+    }
+    else
+    if (cached)
+    {
+        /* static scene's lists are kept for the next frame */
+        pending = 1;
+    }
+    else
+    {
+        release_pools();
+    }
+
+#if RT_OPTS_UPDATE_EXT0 != 0
+    } /* --<----<-- skip update2 --<----<-- */
+    else
+    {
+        pending = 1;
+    }
+#endif /* RT_OPTS_UPDATE_EXT0 */
+
+    /* in pipelined mode frame time is measured
+     * from one finished frame to the next */
+    tfrm = stamp_prof(RT_PROF_FRAME, tfrm);
+
+    posted = 0;
+
+    /* merge current frame's times into profiler statistics */
+    merge_prof();
+}
+
+/*
+ * Render frames of "num" cameras with indices from "cams" array
+ * for a given "time" into respective framebuffers from "frames" array
+ * (SIMD-aligned, with scene's dimensions). Scene is updated only once
+ * with the first camera, for others only camera-dependent data is rebuilt:
+ * surfaces' tile lists, camera's surface list and screen tiling.
+ * Arrays' level-of-detail is selected from the first camera.
+ * Current camera and framebuffer are restored upon return.
+ */
+rt_void rt_Scene::render_cams(rt_time time, rt_si32 num, rt_si32 *cams,
+                              rt_ui32 **frames)
+{
+    rt_Camera *cur = cam;
+    rt_si32 idx = cam_idx;
+    rt_ui32 *frm = frame;
+    rt_time tbeg = 0;
+    rt_si32 k, mode;
+
+    /* frame in flight shares the tilebuffer with frames below */
+    render_wait();
+
+    for (k = 0; k < num; k++)
+    {
+        /* select camera by index */
+        cam = cam_head;
+        cam_idx = 0;
+
+        while (cam_idx < cams[k] && cam->next != RT_NULL)
+        {
+            cam = cam->next;
+            cam_idx++;
+        }
+
+        frame = frames[k];
+
+        if (k == 0)
+        {
+            prepare(time);
+        }
+        else
+#if RT_OPTS_UPDATE_EXT0 != 0
+        if ((opts & RT_OPTS_UPDATE_EXT0) == 0)
+#endif /* RT_OPTS_UPDATE_EXT0 */
+        {
+            rt_time tprv = prf_f[pidx][RT_PROF_TILING];
+
+            tprf = get_usec();
+
+            update_cam();
+
+            /* tiling time accumulates over cameras */
+            stamp_prof(RT_PROF_TILING, tprf);
+            prf_f[pidx][RT_PROF_TILING] += tprv;
+        }
+
+        /* render the camera's frame to completion,
+         * the next one reuses the same backend structures */
+        mode = render_init();
+        tbeg = k == 0 ? trnd : tbeg;
+
+        if (mode > 0)
+        {
+            this->f_render(tdata, thnum, 1);
+        }
+        else
+        if (mode == 0)
+        {
+            render_scene(this, -thnum, 1);
+        }
+    }
+
+    /* render time covers all cameras */
+    trnd = tbeg;
+
+    render_wait();
+
+    cam = cur;
+    cam_idx = idx;
+    frame = frm;
+
+    /* tiling is left from the last camera */
+    c_cam = RT_NULL;
+}
+
+/*
+ * Store time elapsed since "time" for given profiler "phase",
+ * return current time for the next stamp. Render and frame times
+ * go to the posted frame's buffer, update phases to the one prepared.
+ */
+rt_time rt_Scene::stamp_prof(rt_si32 phase, rt_time time)
+{
+    static
+    rt_pstr phases[RT_PROF_PHASES] =
+    {
+        "update 0.5",
+        "wait update 1",
+        "wait update 2",
+        "update 2.5",
+        "wait update 3",
+        "tiling",
+        "wait render",
+        "frame",
+    };
+
+    rt_time tcur = get_usec();
+
+    rt_si32 k = phase == RT_PROF_RENDER || phase == RT_PROF_FRAME ?
+                                                            ppst : pidx;
+
+    prf_f[k][phase] = tcur - time;
+
+    trace_event(trace, phases[phase], time, tcur - time, 0);
+
+    return tcur;
+}
+
+/*
+ * Merge posted frame's per-phase and per-thread times
+ * into profiler statistics, then reset them for reuse.
+ */
+rt_void rt_Scene::merge_prof()
+{
+    rt_si32 i, k;
+
+    /* in pipelined mode the next frame's update
+     * is kept in the other buffer until its render */
+    rt_time *prf_c = prf_f[ppst];
+
+    for (k = 0; k < RT_PROF_PHASES; k++)
+    {
+        if (prf_c[k] < 0)
+        {
+            continue;
+        }
+
+        rt_PROF *prf = &prof[k];
+        rt_time tmax = 0, tsum = 0;
+
+        prf->min = prf->cnt == 0 ? prf_c[k] : RT_MIN(prf->min, prf_c[k]);
+        prf->max = prf->cnt == 0 ? prf_c[k] : RT_MAX(prf->max, prf_c[k]);
+        prf->sum += prf_c[k];
+        prf->cnt++;
+
+        for (i = 0; i < thnum; i++)
+        {
+            rt_time *prf_t = tharr[i]->prf_t[ppst];
+
+            tmax = RT_MAX(tmax, prf_t[k]);
+            tsum += prf_t[k];
+
+            tharr[i]->prf_s[k] += prf_t[k];
+        }
+
+        prf->thr_max += tmax;
+        prf->thr_sum += tsum;
+    }
+
+    /* reset posted frame's times for reuse */
+    for (k = 0; k < RT_PROF_PHASES; k++)
+    {
+        prf_c[k] = -1;
+    }
+    for (i = 0; i < thnum; i++)
+    {
+        memset(tharr[i]->prf_t[ppst], 0, sizeof(rt_time) * RT_PROF_PHASES);
+    }
+
+#if RT_FEAT_COUNTERS
+
+    /* fold backend's per-lane sums of active SIMD lanes */
+    for (i = 0; i < thnum; i++)
+    {
+        rt_SIMD_INFOX *s_inf = tharr[i]->s_inf;
+
+        s_inf->cnt_rtl = 0;
+        s_inf->cnt_cll = 0;
+
+        for (k = 0; k < S; k++)
+        {
+            s_inf->cnt_rtl += s_inf->cnt_lnr[k];
+            s_inf->cnt_cll += s_inf->cnt_lnc[k];
+        }
+    }
+
+    /* sum backend's hot-path counters over threads,
+     * counters are laid out sequentially from cnt_pri */
+    for (k = 0; k < RT_CNT_TOTAL; k++)
     {
-        this->f_update(tdata, thnum, 3);
+        cnt_f[k] = 0;
+
+        for (i = 0; i < thnum; i++)
+        {
+            cnt_f[k] += (&tharr[i]->s_inf->cnt_pri)[k];
+        }
+
+        cnt_s[k] += cnt_f[k];
     }
-    else
-#endif /* RT_OPTS_THREAD */
+
+#endif /* RT_FEAT_COUNTERS */
+}
+
+/*
+ * Merge surfaces' tile lists into tilebuffer rows with given "index"
+ * as part of the multi-threaded screen tiling. Surfaces' row indices
+ * built in "stile" allow each thread to relink only its own rows.
+ */
+rt_void rt_Scene::merge_tiles(rt_si32 index)
+{
+    rt_si32 i, j, k, tline;
+
+    for (i = index; i < tiles_in_col; i += thnum)
     {
-        update_scene(this, -thnum, 3);
+        memset(tiles + i * tiles_in_row, 0, sizeof(rt_ELEM *) * tiles_in_row);
     }
 
-    /* screen tiling */
-    rt_si32 tline, j;
+    rt_ELEM *elm, *nxt;
 
-#if RT_OPTS_TILING != 0
-    if ((opts & RT_OPTS_TILING) != 0)
+    /* traverse reversed "clist" to keep original "clist's" order
+     * and optimize trnode handling for each tile */
+    for (elm = ctail; elm != RT_NULL; elm = elm->next)
     {
-        memset(tiles, 0, sizeof(rt_ELEM *) * tiles_in_row * tiles_in_col);
-
-        rt_ELEM *elm, *nxt, *ctail = RT_NULL, **ptr = &ctail;
+        rt_Node *nd = (rt_Node *)((rt_BOUND *)elm->temp)->obj;
 
-        /* build exact copy of reversed "clist" (should be cheap),
-         * trnode elements become tailing rather than heading,
-         * elements grouping for cached transform is retained */
-        for (nxt = clist; nxt != RT_NULL; nxt = nxt->next)
+        /* skip trnode elements from reversed "clist"
+         * as they are handled separately for each tile */
+        if (RT_IS_ARRAY(nd))
         {
-            /* alloc new element as "nxt's" copy */
-            elm = (rt_ELEM *)alloc(sizeof(rt_ELEM), RT_QUAD_ALIGN);
-            elm->data = nxt->data;
-            elm->simd = nxt->simd;
-            elm->temp = nxt->temp;
-            /* insert element as list's head */
-            elm->next = *ptr;
-           *ptr = elm;
+            continue;
         }
 
-        /* traverse reversed "clist" to keep original "clist's" order
-         * and optimize trnode handling for each tile */
-        for (elm = ctail; elm != RT_NULL; elm = elm->next)
+        rt_Surface *srf = (rt_Surface *)nd;
+
+        if (srf->tlr == RT_NULL)
         {
-            rt_Node *nd = (rt_Node *)((rt_BOUND *)elm->temp)->obj;
+            continue;
+        }
 
-            /* skip trnode elements from reversed "clist"
-             * as they are handled separately for each tile */
-            if (RT_IS_ARRAY(nd))
-            {
-                continue;
-            }
+        /* first row of the tile-rect owned by this thread */
+        i = srf->tbx[1] + (index - srf->tbx[1] % thnum + thnum) % thnum;
 
-            rt_Surface *srf = (rt_Surface *)nd;
+        for (; i <= srf->tbx[3]; i += thnum)
+        {
+            k = i - srf->tbx[1];
 
-            rt_ELEM *tls = srf->tls, *trn;
+            rt_ELEM *tls = srf->tlr[k], *end = srf->tlr[k + 1], *trn;
 
             if (srf->trnode != RT_NULL && srf->trnode != srf)
             {
-                for (; tls != RT_NULL; tls = nxt)
+                for (; tls != end; tls = nxt)
                 {
-                    i = (rt_word)tls->data >> 16;
                     j = (rt_word)tls->data & 0xFFFF;
 
                     nxt = tls->next;
@@ -3245,7 +5198,8 @@ rt_void rt_Scene::render(rt_time time)
                         tiles[tline + j] = tls;
 
                         /* alloc new trnode element as none has been found */
-                        trn = (rt_ELEM *)alloc(sizeof(rt_ELEM), RT_QUAD_ALIGN);
+                        trn = (rt_ELEM *)tharr[index]->alloc(sizeof(rt_ELEM),
+                                                            RT_QUAD_ALIGN);
                         trn->data = (rt_cell)tls; /* trnode's last element */
                         trn->simd = arr->s_srf;
                         trn->temp = trb;
@@ -3257,9 +5211,8 @@ rt_void rt_Scene::render(rt_time time)
             }
             else
             {
-                for (; tls != RT_NULL; tls = nxt)
+                for (; tls != end; tls = nxt)
                 {
-                    i = (rt_word)tls->data >> 16;
                     j = (rt_word)tls->data & 0xFFFF;
 
                     nxt = tls->next;
@@ -3274,113 +5227,7 @@ rt_void rt_Scene::render(rt_time time)
                 }
             }
         }
-
-        if (g_print)
-        {
-            rt_si32 i = 0, j = 0;
-
-            tline = i * tiles_in_row;
-
-            RT_PRINT_TLS_LST(tiles[tline + j], i, j);
-        }
-    }
-    else
-#endif /* RT_OPTS_TILING */
-    {
-        for (i = 0; i < tiles_in_col; i++)
-        {
-            tline = i * tiles_in_row;
-
-            for (j = 0; j < tiles_in_row; j++)
-            {
-                tiles[tline + j] = clist;
-            }
-        }
-    }
-
-    /* aim rays at pixel centers */
-    RT_VEC3_MUL_VAL1(hor, hor, factor);
-    RT_VEC3_MUL_VAL1(ver, ver, factor);
-
-    RT_VEC3_MAD_VAL1(dir, hor, 0.5f);
-    RT_VEC3_MAD_VAL1(dir, ver, 0.5f);
-
-    /* accumulate ambient from camera and all light sources */
-    RT_VEC3_MUL_VAL1(amb, cam->cam->col.hdr, cam->cam->lum[0]);
-    amb[RT_A] = cam->cam->lum[0];
-
-    rt_Light *lgt = RT_NULL;
-
-    for (lgt = lgt_head; lgt != RT_NULL; lgt = lgt->next)
-    {
-        RT_VEC3_MAD_VAL1(amb, lgt->lgt->col.hdr, lgt->lgt->lum[0]);
-        amb[RT_A] += lgt->lgt->lum[0];
-    }
-
-#if RT_OPTS_UPDATE_EXT0 != 0
-    } /* --<----<-- skip update1 --<----<-- */
-#endif /* RT_OPTS_UPDATE_EXT0 */
-
-
-#if RT_OPTS_RENDER_EXT0 != 0
-    if ((opts & RT_OPTS_RENDER_EXT0) == 0)
-    { /* -->---->-- skip render0 -->---->-- */
-#endif /* RT_OPTS_RENDER_EXT0 */
-
-#if 0 /* SIMD-buffers don't normally require reset between frames */
-    reset_color();
-#endif /* enable for SIMD-buffers as a debug option if needed */
-
-    /* multi-threaded render */
-#if RT_OPTS_THREAD != 0
-    if ((opts & RT_OPTS_THREAD) != 0 && this == pfm->get_cur_scene()
-#if RT_OPTS_RENDER_EXT1 != 0
-    &&  (opts & RT_OPTS_RENDER_EXT1) == 0
-#endif /* RT_OPTS_RENDER_EXT1 */
-       )
-    {
-        this->f_render(tdata, thnum, 1);
-    }
-    else
-#endif /* RT_OPTS_THREAD */
-    {
-        render_scene(this, -thnum, 1);
-    }
-
-    pts_c = tharr[0]->s_inf->pts_c[0];
-
-#if RT_OPTS_RENDER_EXT0 != 0
-    } /* --<----<-- skip render0 --<----<-- */
-#endif /* RT_OPTS_RENDER_EXT0 */
-
-
-#if RT_OPTS_UPDATE_EXT0 != 0
-    if ((opts & RT_OPTS_UPDATE_EXT0) == 0)
-    { /* -->---->-- skip update2 -->---->-- */
-#endif /* RT_OPTS_UPDATE_EXT0 */
-
-    /* print state done */
-    if (g_print)
-    {
-        RT_PRINT_STATE_DONE();
-        g_print = RT_FALSE;
-    }
-
-    /* release memory for temporary per-frame allocs */
-    for (i = 0; i < thnum; i++)
-    {
-        tharr[i]->release(tharr[i]->mpool);
-    }
-
-    release(mpool);
-
-#if RT_OPTS_UPDATE_EXT0 != 0
-    } /* --<----<-- skip update2 --<----<-- */
-    else
-    {
-        pending = 1;
     }
-#endif /* RT_OPTS_UPDATE_EXT0 */
 }
 
 /*
@@ -3396,6 +5243,20 @@ rt_void rt_Scene::update_slice(rt_si32 index, rt_si32 phase)
     rt_Light   *lgt;
     rt_Surface *srf;
 
+    rt_time time = get_usec();
+
+    if (phase == 0)
+    {
+        for (i = index; i < upd_num; i += thnum)
+        {
+            rt_Object *obj = upd_arr[i];
+
+            /* update subtree from its parent array updated
+             * sequentially before, root's time is already set */
+            ((rt_Array *)obj->parent)->update_sub(obj, rootobj.time);
+        }
+    }
+    else
     if (phase == 1)
     {
         for (arr = arr_head, i = 0; arr != RT_NULL; arr = arr->next, i++)
@@ -3405,6 +5266,12 @@ rt_void rt_Scene::update_slice(rt_si32 index, rt_si32 phase)
                 continue;
             }
 
+            /* skip arrays switched off by level-of-detail */
+            if (lod_hidden(arr))
+            {
+                continue;
+            }
+
             /* update array's fields from transform matrix
              * updated in sequential phase 0.5 */
             arr->update_fields();
@@ -3443,6 +5310,15 @@ rt_void rt_Scene::update_slice(rt_si32 index, rt_si32 phase)
                 continue;
             }
 
+            /* skip surfaces switched off by level-of-detail,
+             * they are not in any list and are updated in full
+             * once switched back on, hidden surfaces shouldn't
+             * clip visible ones as their fields are kept stale */
+            if (lod_hidden(srf))
+            {
+                continue;
+            }
+
             /* update surface's fields and transform matrix
              * from parent array's transform matrix
              * updated in sequential phase 0.5 */
@@ -3459,6 +5335,12 @@ rt_void rt_Scene::update_slice(rt_si32 index, rt_si32 phase)
                 continue;
             }
 
+            /* skip surfaces switched off by level-of-detail */
+            if (lod_hidden(srf))
+            {
+                continue;
+            }
+
             /* rebuild surface's clip list (cross-surface)
              * based on transform flags updated in 1st phase above */
             tharr[index]->sclip(srf);
@@ -3487,15 +5369,20 @@ rt_void rt_Scene::update_slice(rt_si32 index, rt_si32 phase)
                 RT_PRINT_SRF(srf);
             }
 
-            /* rebuild surface's rfl/rfr surface lists (cross-surface)
-             * based on surface bounds updated in 2nd phase above
-             * and array bounds updated in sequential phase 2.5 */
-            tharr[index]->ssort(srf);
-
-            /* rebuild surface's light/shadow lists (cross-surface)
-             * based on surface bounds updated in 2nd phase above
-             * and array bounds updated in sequential phase 2.5 */
-            tharr[index]->lsort(srf);
+            /* surfaces switched off by level-of-detail
+             * are not in any list, skip their own lists */
+            if (!lod_hidden(srf))
+            {
+                /* rebuild surface's rfl/rfr surface lists (cross-surface)
+                 * based on surface bounds updated in 2nd phase above
+                 * and array bounds updated in sequential phase 2.5 */
+                tharr[index]->ssort(srf);
+
+                /* rebuild surface's light/shadow lists (cross-surface)
+                 * based on surface bounds updated in 2nd phase above
+                 * and array bounds updated in sequential phase 2.5 */
+                tharr[index]->lsort(srf);
+            }
 
             /* update surface's backend-related parts */
             pfm->update0(srf->s_srf);
@@ -3505,6 +5392,136 @@ rt_void rt_Scene::update_slice(rt_si32 index, rt_si32 phase)
 #endif /* enable for SIMD-buffers as a debug option if needed */
         }
     }
+    else
+    if (phase == 4)
+    {
+        for (srf = srf_head, i = 0; srf != RT_NULL; srf = srf->next, i++)
+        {
+            if ((i % thnum) != index)
+            {
+                continue;
+            }
+
+            /* skip surfaces switched off by level-of-detail */
+            if (lod_hidden(srf))
+            {
+                continue;
+            }
+
+            /* rebuild surface's node list (per-surface)
+             * based on transform flags and arrays' bounds
+             * updated in sequential phase 2.5 */
+            tharr[index]->snode(srf);
+        }
+    }
+    else
+    if (phase == 5)
+    {
+        /* global lists don't depend on each other here,
+         * build them on different threads when possible */
+        if (index == 0)
+        {
+            /* rebuild global hierarchical list */
+            hlist = tharr[index]->ssort(RT_NULL);
+        }
+        if (index == 1 % thnum)
+        {
+            /* rebuild global surface/node list */
+            slist = tharr[index]->ssort(RT_NULL);
+            tharr[index]->filter(RT_NULL, &slist);
+        }
+    }
+    else
+    if (phase == 6)
+    {
+        if (index == 0)
+        {
+            /* rebuild global light/shadow list,
+             * "slist" is needed inside */
+            llist = tharr[index]->lsort(RT_NULL);
+        }
+        if (index == 1 % thnum)
+        {
+            /* rebuild camera's surface/node list,
+             * "slist" is needed inside */
+            clist = tharr[index]->ssort(this->cam);
+        }
+    }
+    else
+    if (phase == 7)
+    {
+        merge_tiles(index);
+    }
+    else
+    if (phase == 8)
+    {
+        for (srf = srf_head, i = 0; srf != RT_NULL; srf = srf->next, i++)
+        {
+            if ((i % thnum) != index)
+            {
+                continue;
+            }
+
+            /* skip surfaces switched off by level-of-detail */
+            if (lod_hidden(srf))
+            {
+                continue;
+            }
+
+            /* rebuild surface's tile list (per-surface)
+             * for another camera (see render_cams) */
+            tharr[index]->stile(srf);
+        }
+    }
+    else
+    if (phase == 9)
+    {
+        for (i = index; i < upd_num; i += thnum)
+        {
+            rt_Object *obj = upd_arr[i];
+
+            if (!RT_IS_ARRAY(obj))
+            {
+                continue;
+            }
+
+            arr = (rt_Array *)obj;
+
+            /* update subtree's bounds from surfaces updated
+             * in 2nd phase if they don't contribute to boxes
+             * of arrays above it, mark is set in every update */
+            arr->bnd_upd = !lod_hidden(arr) && bounds_local(arr, arr);
+
+            if (arr->bnd_upd != 0)
+            {
+                arr->update_bounds();
+            }
+        }
+    }
+
+    /* accumulate thread's time in current phase */
+    rt_time tcur = get_usec();
+
+    tharr[index]->prf_t[pidx][phase == 0 ? RT_PROF_UPDATE_05 :
+                              phase == 1 ? RT_PROF_UPDATE_1 :
+                              phase == 2 ? RT_PROF_UPDATE_2 :
+                              phase == 3 ? RT_PROF_UPDATE_3 :
+                              phase == 7 ? RT_PROF_TILING :
+                              phase == 8 ? RT_PROF_TILING :
+                                           RT_PROF_UPDATE_25] += tcur - time;
+
+    /* while worker-threads render the posted frame (in their rings),
+     * the next one is updated sequentially on the main thread */
+    rt_si32 k = posted ? 0 : index + 1;
+
+    trace_event(pfm->get_trace(k), phase == 0 ? "update 0.5" :
+                                   phase == 1 ? "update 1" :
+                                   phase == 2 ? "update 2" :
+                                   phase == 3 ? "update 3" :
+                                   phase == 7 ? "tiling" :
+                                   phase == 8 ? "tiling" :
+                                                "update 2.5",
+                time, tcur - time, 0);
 }
 
 /*
@@ -3518,6 +5535,8 @@ rt_void rt_Scene::render_slice(rt_si32 index, rt_si32 phase)
     rt_real fva[RT_SIMD_WIDTH], fvi[RT_SIMD_WIDTH], fvu; /* v - ver */
     rt_si32 i, n;
 
+    rt_time time = get_usec();
+
     if (pfm->fsaa == RT_FSAA_NO)
     {
         for (i = 0; i < pfm->simd_width; i++)
@@ -3610,35 +5629,16 @@ rt_void rt_Scene::render_slice(rt_si32 index, rt_si32 phase)
         ;
     }
 
+    /* frame's state is filled in "render_post",
+     * antialiasing-dependent fields are set here */
+
 /*  rt_SIMD_CAMERA */
 
     rt_SIMD_CAMERA *s_cam = tharr[index]->s_cam;
 
-    RT_SIMD_SET(s_cam->t_max, RT_INF);
-
-    RT_SIMD_SET(s_cam->dir_x, dir[RT_X]);
-    RT_SIMD_SET(s_cam->dir_y, dir[RT_Y]);
-    RT_SIMD_SET(s_cam->dir_z, dir[RT_Z]);
-
-    RT_SIMD_SET(s_cam->hor_x, hor[RT_X]);
-    RT_SIMD_SET(s_cam->hor_y, hor[RT_Y]);
-    RT_SIMD_SET(s_cam->hor_z, hor[RT_Z]);
-
-    RT_SIMD_SET(s_cam->ver_x, ver[RT_X]);
-    RT_SIMD_SET(s_cam->ver_y, ver[RT_Y]);
-    RT_SIMD_SET(s_cam->ver_z, ver[RT_Z]);
-
     RT_SIMD_SET(s_cam->hor_u, fhu);
     RT_SIMD_SET(s_cam->ver_u, fvu);
 
-    RT_SIMD_SET(s_cam->clamp, (rt_real)255);
-    RT_SIMD_SET(s_cam->cmask, (rt_elem)255);
-
-    RT_SIMD_SET(s_cam->col_r, amb[RT_R]);
-    RT_SIMD_SET(s_cam->col_g, amb[RT_G]);
-    RT_SIMD_SET(s_cam->col_b, amb[RT_B]);
-    RT_SIMD_SET(s_cam->l_amb, amb[RT_A]);
-
     RT_SIMD_SET(s_cam->x_row, (rt_real)(x_row << pfm->fsaa));
     RT_SIMD_SET(s_cam->idx_h, pfm->simd_width);
 
@@ -3646,30 +5646,28 @@ rt_void rt_Scene::render_slice(rt_si32 index, rt_si32 phase)
 
     rt_SIMD_CONTEXT *s_ctx = tharr[index]->s_ctx;
 
-    s_ctx->param[1] = -((opts & RT_OPTS_GAMMA) == 0) & RT_PROP_GAMMA;
-    RT_SIMD_SET(s_ctx->t_min, cam->pov);
     RT_SIMD_SET(s_ctx->wmask, -1);
 
-    RT_SIMD_SET(s_ctx->org_x, pos[RT_X]);
-    RT_SIMD_SET(s_ctx->org_y, pos[RT_Y]);
-    RT_SIMD_SET(s_ctx->org_z, pos[RT_Z]);
-
 /*  rt_SIMD_INFOX */
 
     rt_SIMD_INFOX *s_inf = tharr[index]->s_inf;
 
-    s_inf->ctx = s_ctx;
-    s_inf->cam = s_cam;
-    s_inf->lst = clist;
-
     s_inf->thndx = index;
     s_inf->thnum = thnum;
-    s_inf->depth = depth;
     s_inf->fsaa  = pfm->fsaa;
 
-    s_inf->pt_on = pt_on;
+    /* reset thread's occluder cache, as shadow lists
+     * can be rebuilt at the same addresses in the next frame */
+    s_inf->occ = RT_NULL;
+
+#if RT_OPTS_SHADOW_EXT3 != 0
+    if ((opts & RT_OPTS_SHADOW_EXT3) != 0)
+    {
+        s_inf->occ = tharr[index]->occ;
 
-    RT_SIMD_SET(s_inf->pts_c, pts_c);
+        memset(s_inf->occ, 0, sizeof(rt_ELEM) * lgt_num);
+    }
+#endif /* RT_OPTS_SHADOW_EXT3 */
 
     for (n = RT_MAX(1, pt_on); n > 0; n--)
     {
@@ -3693,6 +5691,13 @@ rt_void rt_Scene::render_slice(rt_si32 index, rt_si32 phase)
         /* render frame based on tilebuffer */
         pfm->render0(s_inf);
     }
+
+    /* accumulate thread's time in render phase */
+    rt_time tcur = get_usec();
+
+    tharr[index]->prf_t[ppst][RT_PROF_RENDER] += tcur - time;
+
+    trace_event(pfm->get_trace(index + 1), "render", time, tcur - time, 0);
 }
 
 /*
@@ -3806,6 +5811,12 @@ rt_si32 rt_Scene::get_pton()
  */
 rt_si32 rt_Scene::set_pton(rt_si32 pton)
 {
+    /* frame in flight reads color-planes */
+    if (posted)
+    {
+        render_wait();
+    }
+
     if ((opts & RT_OPTS_PT) == 0) /* if path-tracer is not optimized out */
     {
         rt_si32 pt_on = this->pt_on;
@@ -3822,6 +5833,104 @@ rt_si32 rt_Scene::set_pton(rt_si32 pton)
     return this->pt_on;
 }
 
+/*
+ * Return pipelined mode: 0 - off, 1 - on.
+ */
+rt_si32 rt_Scene::get_pipe()
+{
+    return this->pipe;
+}
+
+/*
+ * Set pipelined mode: 0 - off, 1 - on.
+ * In pipelined mode "prepare" for the next frame can be called
+ * before "render_wait" for the one posted with "render_post",
+ * its update then runs on this thread while worker-threads render
+ * from alternate copies of backend structs, tilebuffer and heaps.
+ * Alternates are allocated when first turned on between frames,
+ * the mode isn't used with path-tracer or for debug print/skips.
+ */
+rt_si32 rt_Scene::set_pipe(rt_si32 pipe)
+{
+    rt_si32 i;
+
+    if (posted)
+    {
+        render_wait();
+    }
+
+    /* static scene's cache keeps per-frame pools reserved */
+    if (cached)
+    {
+        cached = 0;
+
+        if (pending)
+        {
+            pending = 0;
+            release_pools();
+        }
+    }
+
+    /* per-frame pools left reserved (pending)
+     * can't have persistent allocs after them */
+    if (pipe && dbuf == RT_NULL && pending == 0)
+    {
+        dbuf_num = lgt_num + arr_num * 3 + srf_num;
+        dbuf = (rt_DBUF *)alloc(sizeof(rt_DBUF) * dbuf_num, RT_ALIGN);
+
+        rt_DBUF *buf = dbuf;
+
+        rt_Light *lgt;
+
+        for (lgt = lgt_head; lgt != RT_NULL; lgt = lgt->next, buf++)
+        {
+            buf->ptr = (rt_pntr *)&lgt->s_lgt;
+            buf->size = sizeof(rt_SIMD_LIGHT);
+        }
+
+        rt_Array *arr;
+
+        for (arr = arr_head; arr != RT_NULL; arr = arr->next, buf += 3)
+        {
+            buf[0].ptr = (rt_pntr *)&arr->s_srf;
+            buf[1].ptr = (rt_pntr *)&arr->s_inb;
+            buf[2].ptr = (rt_pntr *)&arr->s_bvb;
+            buf[0].size = arr->ssize;
+            buf[1].size = arr->ssize;
+            buf[2].size = arr->ssize;
+        }
+
+        rt_Surface *srf;
+
+        for (srf = srf_head; srf != RT_NULL; srf = srf->next, buf++)
+        {
+            buf->ptr = (rt_pntr *)&srf->s_srf;
+            buf->size = srf->ssize;
+        }
+
+        for (i = 0; i < dbuf_num; i++)
+        {
+            dbuf[i].alt = alloc(dbuf[i].size, RT_SIMD_ALIGN);
+        }
+
+        tiles_alt = (rt_ELEM **)
+            alloc(tiles_in_row * tiles_in_col * sizeof(rt_ELEM *), RT_ALIGN);
+
+        memset(tiles_alt, 0, tiles_in_row * tiles_in_col * sizeof(rt_ELEM *));
+
+        spare = new rt_Heap(f_alloc, f_free);
+
+        for (i = 0; i < thnum; i++)
+        {
+            tharr[i]->spare = new rt_Heap(f_alloc, f_free);
+        }
+    }
+
+    this->pipe = pipe && dbuf != RT_NULL;
+
+    return this->pipe;
+}
+
 /*
  * Return current camera index.
  */
@@ -3895,7 +6004,386 @@ rt_void rt_Scene::save_frame(rt_si32 index)
     tex.y_dim = -y_res;
 
     /* save frame's image */
+    rt_time time = get_usec();
+
     save_image(this, name, &tex);
+
+    pfm->add_trace("save frame", time);
+}
+
+/*
+ * Get memory accounting of scene's heap (index < 0)
+ * or heap of the thread with given "index" (see rt_MSTAT).
+ * Per-frame high-water is reset at the beginning of each frame.
+ */
+rt_void rt_Scene::get_mstat(rt_si32 index, rt_MSTAT *mst)
+{
+    if (index < 0)
+    {
+        rt_Heap::get_mstat(mst);
+    }
+    else
+    {
+        tharr[RT_MIN(index, thnum - 1)]->get_mstat(mst);
+    }
+}
+
+/*
+ * Allocate SIMD-buffers for all nodes in one block after the hierarchy.
+ * Buffers are only touched by the path-tracer, while nodes' SIMD structures
+ * are read on every intersection, allocating buffers along with each node
+ * would spread nodes' SIMD structures apart by the size of the buffers.
+ */
+rt_void rt_Scene::alloc_buffers()
+{
+    rt_size size = (rt_size)RT_BUFFER_POOL * thnum;
+    rt_size full = size * (arr_num + srf_num);
+
+    rt_byte *ptr = (rt_byte *)alloc(full, RT_SIMD_ALIGN);
+    memset(ptr, 255, full);
+
+    rt_Array *arr;
+
+    for (arr = arr_head; arr != RT_NULL; arr = arr->next, ptr += size)
+    {
+        arr->s_srf->msc_p[0] = ptr;
+    }
+
+    rt_Surface *srf;
+
+    for (srf = srf_head; srf != RT_NULL; srf = srf->next, ptr += size)
+    {
+        srf->s_srf->msc_p[0] = ptr;
+    }
+}
+
+/*
+ * Return total size of SIMD-buffers (in scene's heap) in bytes.
+ */
+rt_size rt_Scene::get_bsize()
+{
+    return (opts & RT_OPTS_BUFFERS) == 0 ?
+                (rt_size)(arr_num + srf_num) * RT_BUFFER_POOL * thnum : 0;
+}
+
+/*
+ * Return profiler statistics for given "phase".
+ */
+rt_PROF* rt_Scene::get_prof(rt_si32 phase)
+{
+    return &prof[RT_MAX(0, RT_MIN(phase, RT_PROF_PHASES - 1))];
+}
+
+/*
+ * Return accumulated time of thread with given "index" for given "phase".
+ */
+rt_time rt_Scene::get_prof(rt_si32 index, rt_si32 phase)
+{
+    return tharr[RT_MAX(0, RT_MIN(index, thnum - 1))]->
+            prf_s[RT_MAX(0, RT_MIN(phase, RT_PROF_PHASES - 1))];
+}
+
+/*
+ * Reset profiler statistics.
+ */
+rt_void rt_Scene::reset_prof()
+{
+    rt_si32 i;
+
+    memset(prof, 0, sizeof(rt_PROF) * RT_PROF_PHASES);
+
+    memset(cnt_f, 0, sizeof(rt_time) * RT_CNT_TOTAL);
+    memset(cnt_s, 0, sizeof(rt_time) * RT_CNT_TOTAL);
+
+    for (i = 0; i < thnum; i++)
+    {
+        memset(tharr[i]->prf_s, 0, sizeof(rt_time) * RT_PROF_PHASES);
+    }
+}
+
+/*
+ * Save profiler statistics to a text file.
+ */
+rt_void rt_Scene::save_prof(rt_si32 index)
+{
+    static
+    rt_pstr phases[RT_PROF_PHASES] =
+    {
+        "update 0.5",
+        "update 1  ",
+        "update 2  ",
+        "update 2.5",
+        "update 3  ",
+        "tiling    ",
+        "render    ",
+        "frame     ",
+    };
+
+    rt_char name[20];
+
+    strncpy(name, "prfXXX.txt", 20);
+
+    /* prepare filename string */
+    name[5] = '0' + (index % 10);
+    index /= 10;
+    name[4] = '0' + (index % 10);
+    index /= 10;
+    name[3] = '0' + (index % 10);
+
+    rt_pstr path = RT_PATH_DUMP;
+    rt_size len = strlen(path);
+    rt_char *fullpath = (rt_char *)alloc(len + strlen(name) + 1, 0);
+
+    strcpy(fullpath, path);
+    strcpy(fullpath + len, name);
+
+    rt_File fl(fullpath, "w+");
+    rt_File *f = &fl;
+
+    /* release memory for temporary fullpath string,
+     * would also release all allocs made after fullpath */
+    release(fullpath);
+
+    if (f->error() != 0)
+    {
+        return;
+    }
+
+    rt_si32 i, k;
+
+    /* per-phase times (usec) per frame, imbalance for threaded phases */
+    f->fprint("phase         frames         min         avg         max  imbal\n");
+
+    for (k = 0; k < RT_PROF_PHASES; k++)
+    {
+        rt_PROF *prf = &prof[k];
+
+        f->fprint("%s %9d %11ld %11ld %11ld", phases[k], prf->cnt,
+            (long)prf->min, (long)(prf->cnt ? prf->sum / prf->cnt : 0),
+            (long)prf->max);
+
+        if (prf->thr_sum > 0)
+        {
+            f->fprint("  %5.2f\n",
+                (rt_real)prf->thr_max * thnum / (rt_real)prf->thr_sum);
+        }
+        else
+        {
+            f->fprint("      -\n");
+        }
+    }
+
+    /* per-thread average times (usec) per frame in threaded phases */
+    f->fprint("\nthread     update 1    update 2    update 3      render\n");
+
+    for (i = 0; i < thnum; i++)
+    {
+        f->fprint("%6d", i);
+
+        for (k = 0; k < RT_PROF_PHASES; k++)
+        {
+            if (k != RT_PROF_UPDATE_1 && k != RT_PROF_UPDATE_2
+            &&  k != RT_PROF_UPDATE_3 && k != RT_PROF_RENDER)
+            {
+                continue;
+            }
+
+            f->fprint(" %11ld", (long)(prof[k].cnt ?
+                            tharr[i]->prf_s[k] / prof[k].cnt : 0));
+        }
+
+        f->fprint("\n");
+    }
+
+#if RT_FEAT_COUNTERS
+
+    static
+    rt_pstr counters[RT_CNT_SECONDARY] =
+    {
+        "primary   ",
+        "shadow    ",
+        "qd roots  ",
+        "qd lanes  ",
+        "clip tests",
+        "clip lanes",
+        "elements  ",
+    };
+
+    /* backend's hot-path counters (in SIMD packets or lanes) per frame */
+    rt_si32 frames = RT_MAX(1, prof[RT_PROF_FRAME].cnt);
+
+    f->fprint("\ncounter          last         avg\n");
+
+    for (k = 0; k < RT_CNT_TOTAL; k++)
+    {
+        i = k;
+
+        if (k < RT_CNT_SECONDARY)
+        {
+            f->fprint("%s", counters[k]);
+        }
+        else
+        {
+            /* secondary rays are indexed by remaining depth,
+             * print them in the order of increasing level */
+            i = RT_CNT_SECONDARY + depth - (k - RT_CNT_SECONDARY + 1);
+            f->fprint("level %4d", k - RT_CNT_SECONDARY + 1);
+
+            if (i < RT_CNT_SECONDARY)
+            {
+                f->fprint(" %11ld %11ld\n", 0L, 0L);
+                continue;
+            }
+        }
+
+        f->fprint(" %11ld %11ld\n", (long)cnt_f[i], (long)(cnt_s[i] / frames));
+    }
+
+    /* share of active SIMD lanes out of all lanes of counted packets */
+    rt_real lanes = (rt_real)pfm->simd_width;
+
+    f->fprint("\nqd util    %10.2f%%\n", cnt_s[RT_CNT_ROOTS] > 0 ?
+        100.0f * cnt_s[RT_CNT_ROOTS_LANES] / (cnt_s[RT_CNT_ROOTS] * lanes) :
+        0.0f);
+    f->fprint("clip util  %10.2f%%\n", cnt_s[RT_CNT_CLIP] > 0 ?
+        100.0f * cnt_s[RT_CNT_CLIP_LANES] / (cnt_s[RT_CNT_CLIP] * lanes) :
+        0.0f);
+
+#endif /* RT_FEAT_COUNTERS */
+}
+
+/*
+ * Find cached SIMD target for given "cpu" key (supported targets mask)
+ * and "thnum" (thread-pool size) in the cache file, return 0 if not found.
+ */
+static
+rt_si32 load_tune(rt_si32 cpu, rt_si32 thnum)
+{
+    rt_si32 rec[3], simd = 0;
+
+    rt_File fl(RT_PATH_DUMP_SIMD, "rb");
+    rt_File *f = &fl;
+
+    while (f->error() == 0 && f->load(rec, sizeof(rt_si32), 3) == 3)
+    {
+        if (rec[0] == cpu && rec[1] == thnum)
+        {
+            simd = rec[2];
+        }
+    }
+
+    return simd;
+}
+
+/*
+ * Append SIMD target "simd" chosen for given "cpu" key and "thnum"
+ * to the cache file, the last matching record takes precedence on load.
+ */
+static
+rt_void save_tune(rt_si32 cpu, rt_si32 thnum, rt_si32 simd)
+{
+    rt_si32 rec[3] = {cpu, thnum, simd};
+
+    rt_File fl(RT_PATH_DUMP_SIMD, "ab");
+    rt_File *f = &fl;
+
+    if (f->error() == 0)
+    {
+        f->save(rec, sizeof(rt_si32), 3);
+    }
+}
+
+/*
+ * Pick the fastest of the supported SIMD targets by rendering "frms" frames
+ * of the scene at given "time" on each of them after one warm-up frame,
+ * targets incompatible with current antialiasing mode are skipped.
+ * The widest target is not always the fastest (AVX-512 downclocking, _r8).
+ * Return chosen target in set_simd format and keep it active.
+ */
+rt_si32 rt_Scene::tune_simd(rt_time time, rt_si32 frms)
+{
+    rt_si32 i, j, mask, simd = pfm->simd, best = simd;
+    rt_time tcur, tmin = -1;
+
+    /* supported targets mask serves as CPU key in the cache,
+     * as there is no portable way to query CPU model in the engine */
+    rt_si32 cpu = pfm->s_mask;
+
+    if (pfm->t_cach != 0)
+    {
+        simd = load_tune(cpu, pfm->thnum);
+
+        if (simd != 0 && pfm->set_simd(simd) == simd)
+        {
+            return simd;
+        }
+
+        simd = best;
+    }
+
+    for (i = 0; i < 32; i++)
+    {
+        mask = pfm->s_mask & (1 << i);
+
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        /* check if the target was accepted */
+        pfm->set_simd(from_mask(mask));
+
+        if (pfm->s_mode != mask)
+        {
+            continue;
+        }
+
+        render(time);
+
+        tcur = get_usec();
+
+        for (j = 0; j < frms; j++)
+        {
+            render(time);
+        }
+
+        tcur = get_usec() - tcur;
+
+        if (tmin < 0 || tcur < tmin)
+        {
+            tmin = tcur;
+            best = pfm->simd;
+        }
+    }
+
+    /* keep initial target if timer is not available */
+    best = pfm->set_simd(tmin > 0 ? best : simd);
+
+    if (pfm->t_cach != 0)
+    {
+        save_tune(cpu, pfm->thnum, best);
+    }
+
+    /* drop warm-up frames from path-tracer
+     * accumulation and profiler statistics */
+    if (pt_on)
+    {
+        reset_pseed();
+        reset_color();
+    }
+
+    reset_prof();
+
+    return best;
+}
+
+/*
+ * Return backend's hot-path "counter" summed over threads for last frame,
+ * always 0 unless RT_FEAT_COUNTERS is enabled in tracer.h.
+ */
+rt_time rt_Scene::get_cnts(rt_si32 counter)
+{
+    return cnt_f[RT_MAX(0, RT_MIN(counter, RT_CNT_TOTAL - 1))];
 }
 
 /*
@@ -3913,6 +6401,12 @@ rt_Scene::~rt_Scene()
 {
     rt_si32 i;
 
+    /* finish the frame in flight */
+    if (posted)
+    {
+        render_wait();
+    }
+
     pfm->del_scene(this);
 
     /* destroy scene threads array */
@@ -3924,6 +6418,11 @@ rt_Scene::~rt_Scene()
     /* destroy object hierarchy */
     delete root;
 
+    if (spare != RT_NULL)
+    {
+        delete spare;
+    }
+
     /* destroy textures */
     while (tex_head)
     {
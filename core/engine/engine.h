@@ -35,9 +35,20 @@
 #define RT_SETAFFINITY          1  /* enables thread-affinity and core-count */
 #endif /* RT_SETAFFINITY */
 
+#ifndef RT_BUFFER_WARN
+#define RT_BUFFER_WARN          1024 /* MB of SIMD-buffers to log a warning */
+#endif /* RT_BUFFER_WARN */
+
+#define RT_POOL_FRAMES          64 /* frames per window to shrink memory pools */
+
 #define RT_TILE_W               8  /* screen tile width  in pixels (%S == 0) */
 #define RT_TILE_H               8  /* screen tile height in pixels */
 
+#define RT_LOD_SIZE_OFF         32  /* projected size in pixels for LOD off */
+#define RT_LOD_SIZE_ON          64  /* projected size in pixels for LOD on */
+
+#define RT_UPDATE_SPLIT         256 /* objects in hierarchy for parallel 0.5 */
+
 /*
  * Floating point thresholds,
  * values have been roughly selected for single-precision,
@@ -45,6 +56,7 @@
  */
 #define RT_TILE_THRESHOLD       0.2f
 #define RT_LINE_THRESHOLD       0.01f
+#define RT_FRST_THRESHOLD       0.01f /* <- relative for tile sub-frustums */
 
 /*
  * Fullscreen antialiasing modes.
@@ -58,6 +70,19 @@
 #define RT_FSAA_REGULAR         0 /* makes AA-grid regular if 1 */
 #endif /* RT_FSAA_REGULAR */
 
+/*
+ * Frame profiler phases.
+ */
+#define RT_PROF_UPDATE_05       0 /* mixed: arrays' transform matrices */
+#define RT_PROF_UPDATE_1        1 /* multi-threaded: surfaces' data fields */
+#define RT_PROF_UPDATE_2        2 /* multi-threaded: clip, bounds and tiles */
+#define RT_PROF_UPDATE_25       3 /* mixed: arrays' bounds, global lists */
+#define RT_PROF_UPDATE_3        4 /* multi-threaded: cross-surface lists */
+#define RT_PROF_TILING          5 /* multi-threaded: screen tiling by rows */
+#define RT_PROF_RENDER          6 /* multi-threaded: backend's render0 */
+#define RT_PROF_FRAME           7 /* whole frame */
+#define RT_PROF_PHASES          8
+
 /* Classes */
 
 class rt_Platform;
@@ -73,6 +98,11 @@ typedef rt_void (*rt_FUNC_TERM)(rt_pntr tdata, rt_si32 thnum);
 typedef rt_void (*rt_FUNC_UPDATE)(rt_pntr tdata, rt_si32 thnum, rt_si32 phase);
 typedef rt_void (*rt_FUNC_RENDER)(rt_pntr tdata, rt_si32 thnum, rt_si32 phase);
 
+/* flags for render "phase", platforms which can't return before the phase
+ * is finished run it to completion on RT_RENDER_POST, then ignore the WAIT */
+#define RT_RENDER_POST      0x100 /* start phase on the thread pool, return */
+#define RT_RENDER_WAIT      0x200 /* block until the started phase finishes */
+
 /*
  * Platform abstraction container.
  */
@@ -86,6 +116,19 @@ class rt_Platform : private rt_LogRedirect, public rt_Heap
     rt_si32             s_mask;
     rt_si32             s_mode;
 
+    /* SIMD target autotune mode: warm-up frames
+     * per target (0 - off), use of the cache file
+     * and the scene the target was last tuned for */
+    rt_si32             t_frms;
+    rt_si32             t_cach;
+    rt_Scene           *t_scn;
+
+    /* event trace rings: 0th for the main thread,
+     * i+1 for i-th worker thread (RT_NULL - not allocated) */
+    rt_TRACE           *trc_arr;
+    rt_si32             trc_num;
+    rt_si32             trc_on;
+
     /* thread management functions */
     rt_FUNC_INIT        f_init;
     rt_FUNC_TERM        f_term;
@@ -117,6 +160,11 @@ class rt_Platform : private rt_LogRedirect, public rt_Heap
     rt_Scene           *tail;
     rt_Scene           *cur;
 
+    /* scenes rendered together in one
+     * thread-pool dispatch (see render_batch) */
+    rt_Scene          **b_arr;
+    rt_si32             b_num;
+
 /*  methods */
 
     rt_void     add_scene(rt_Scene *scn);
@@ -143,7 +191,13 @@ class rt_Platform : private rt_LogRedirect, public rt_Heap
     rt_si32     get_thnum();
     rt_si32     set_thnum(rt_si32 thnum);
 
+    rt_si32     get_simd();
     rt_si32     set_simd(rt_si32 simd);
+    rt_si32     set_tune(rt_si32 frms, rt_si32 cach);
+    rt_si32     set_trace(rt_si32 size);
+    rt_TRACE*   get_trace(rt_si32 index);
+    rt_void     add_trace(rt_pstr name, rt_time time);
+    rt_void     save_trace(rt_si32 index);
     rt_si32     set_fsaa(rt_si32 fsaa);
     rt_si32     get_fsaa_max();
     rt_si32     get_fsaa();
@@ -153,10 +207,32 @@ class rt_Platform : private rt_LogRedirect, public rt_Heap
     rt_Scene*   set_cur_scene(rt_Scene *scn);
     rt_void     next_scene();
 
+    rt_void     render_batch(rt_si32 num, rt_Scene **scn, rt_time *time);
+    rt_void     render_slice(rt_si32 index, rt_si32 phase);
+
     friend      class rt_SceneThread;
     friend      class rt_Scene;
 };
 
+/******************************************************************************/
+/********************************   PROFILER   ********************************/
+/******************************************************************************/
+
+/*
+ * Frame profiler statistics accumulated per phase, times in microseconds.
+ * Thread times are only collected in multi-threaded phases, their ratio
+ * (thr_max * thnum / thr_sum) gives per-thread imbalance (1.0 is ideal).
+ */
+struct rt_PROF
+{
+    rt_si32             cnt;    /* number of frames where phase was run */
+    rt_time             min;    /* phase's min time per frame */
+    rt_time             max;    /* phase's max time per frame */
+    rt_time             sum;    /* phase's total time across frames */
+    rt_time             thr_max;/* slowest thread's time summed over frames */
+    rt_time             thr_sum;/* all threads' time summed over frames */
+};
+
 /******************************************************************************/
 /*********************************   THREAD   *********************************/
 /******************************************************************************/
@@ -178,6 +254,14 @@ class rt_SceneThread : public rt_Heap
      * projected bbox in the tilebuffer */
     rt_si32            *txmin;
     rt_si32            *txmax;
+    /* signed distances of surface's bounding
+     * sphere to tile sub-frustums' side planes */
+    rt_real            *tdx;
+    rt_real            *tdy;
+    /* unit normals of tile sub-frustums' side
+     * planes, oriented towards "hor" and "ver" */
+    rt_vec4            *tnx;
+    rt_vec4            *tny;
     /* temporary bbox verts buffer */
     rt_VERT            *verts;
 
@@ -192,12 +276,36 @@ class rt_SceneThread : public rt_Heap
      * for temporary per-frame allocs */
     rt_pntr             mpool;
     rt_ui32             msize;
+    rt_size             mbase;  /* heap's live bytes before the pool */
+    rt_ui32             mpeak;  /* pool's high-water in current window */
+
+    /* spare heap with per-frame allocs
+     * of the frame in flight (see set_pipe) */
+    rt_Heap            *spare;
+    rt_pntr             spool;
+    rt_size             sbase;
+
+    /* mark of camera-dependent allocs
+     * in static scene's kept pool */
+    rt_pntr             cpool;
+
+    /* thread's own occluder cache,
+     * one element per light (see tracer.h) */
+    rt_ELEM            *occ;
+
+    /* per-phase profiler times for current
+     * frame (per frame buffer, see set_pipe)
+     * and accumulated */
+    rt_time             prf_t[2][RT_PROF_PHASES];
+    rt_time             prf_s[RT_PROF_PHASES];
 
 /*  methods */
 
     private:
 
     rt_void     tiling(rt_vec2 p1, rt_vec2 p2);
+    rt_void     frustum(rt_Surface *srf);
+    rt_bool     frustum(rt_si32 i, rt_si32 j, rt_vec4 q, rt_real r);
 
     rt_ELEM*    insert(rt_Object *obj, rt_ELEM **ptr, rt_ELEM *tem);
 
@@ -216,6 +324,7 @@ class rt_SceneThread : public rt_Heap
     rt_void     snode(rt_Surface *srf);
     rt_void     sclip(rt_Surface *srf);
     rt_void     stile(rt_Surface *srf);
+    rt_si32     slod(rt_Array *arr);
 
     rt_ELEM*    ssort(rt_Object *obj);
     rt_ELEM*    lsort(rt_Object *obj);
@@ -225,6 +334,17 @@ class rt_SceneThread : public rt_Heap
 /**********************************   SCENE   *********************************/
 /******************************************************************************/
 
+/*
+ * Backend struct double-buffered in pipelined mode (see set_pipe),
+ * object's field at "ptr" is swapped with "alt" before every frame.
+ */
+struct rt_DBUF
+{
+    rt_pntr            *ptr;    /* address of object's SIMD pointer */
+    rt_pntr             alt;    /* alternate copy of the SIMD struct */
+    rt_si32             size;   /* size of the SIMD struct in bytes */
+};
+
 /*
  * Scene manager (or instance of the engine).
  */
@@ -274,8 +394,48 @@ class rt_Scene : private rt_Registry, public rt_List<rt_Scene>
      * for temporary per-frame allocs */
     rt_pntr             mpool;
     rt_ui32             msize;
+    rt_size             mbase;  /* heap's live bytes before the pool */
+    rt_ui32             mpeak;  /* pool's high-water in current window */
+    rt_si32             mfrms;  /* frames in current pool-sizing window */
     /* pending release flag */
     rt_si32             pending;
+    /* static scene's update cache, per-frame lists
+     * of the last update are kept (pending) and reused
+     * while only cameras change (see RT_OPTS_STATIC) */
+    rt_si32             cached;
+    rt_si32             c_simd; /* SIMD target of cached lists */
+    rt_Camera          *c_cam;  /* camera of cached tiling */
+    rt_pntr             cpool;  /* mark of camera-dependent allocs */
+    /* level-of-detail selection, set once
+     * surfaces' tile-rects are projected */
+    rt_si32             lod_sel;
+    /* frame posted for render_wait
+     * (2 - rendering on thread pool,
+     *  3 - in platform's render batch) */
+    rt_si32             posted;
+
+    /* pipelined mode, next frame is prepared
+     * while the posted one is being rendered */
+    rt_si32             pipe;
+    /* frame in flight uses alternate buffers
+     * and spare heaps (until render_wait) */
+    rt_si32             flip;
+    /* double-buffered SIMD structs */
+    rt_DBUF            *dbuf;
+    rt_si32             dbuf_num;
+    /* alternate tilebuffer */
+    rt_ELEM           **tiles_alt;
+    /* spare heap with per-frame allocs
+     * of the frame in flight */
+    rt_Heap            *spare;
+    rt_pntr             spool;
+    rt_size             sbase;
+
+    /* profiler's timestamps carried
+     * across the frame's stages */
+    rt_time             tprf;
+    rt_time             tfrm;
+    rt_time             trnd;
 
     /* thread management functions */
     rt_FUNC_UPDATE      f_update;
@@ -295,6 +455,9 @@ class rt_Scene : private rt_Registry, public rt_List<rt_Scene>
     rt_ELEM            *llist;
     /* camera's surface/node list */
     rt_ELEM            *clist;
+    /* reversed copy of "clist"
+     * for multi-threaded tiling */
+    rt_ELEM            *ctail;
 
     /* ray-position variables */
     rt_vec4             pos;
@@ -316,14 +479,64 @@ class rt_Scene : private rt_Registry, public rt_List<rt_Scene>
     rt_si32             fsaa;
     /* root of the object hierarchy */
     rt_Array           *root;
+    /* hierarchy split for parallel phase 0.5,
+     * arrays above the subtrees (parents first)
+     * are updated sequentially before them */
+    rt_Array          **upd_top;
+    rt_si32             upd_cnt;
+    rt_Object         **upd_arr;
+    rt_si32             upd_num;
     /* current camera */
     rt_Camera          *cam;
     rt_si32             cam_idx;
 
+    /* SIMD target chosen by autotune
+     * for this scene (0 - not tuned yet) */
+    rt_si32             t_simd;
+
+    /* per-phase profiler times for current
+     * frame (-1 if not run) and statistics,
+     * in pipelined mode the next frame's update
+     * is stamped while the posted one renders,
+     * thus times are kept per frame buffer:
+     * "pidx" - frame being prepared,
+     * "ppst" - frame posted for render */
+    rt_time             prf_f[2][RT_PROF_PHASES];
+    rt_si32             pidx;
+    rt_si32             ppst;
+    rt_PROF             prof[RT_PROF_PHASES];
+
+    /* backend's hot-path counters summed over
+     * threads for current frame and accumulated */
+    rt_time             cnt_f[RT_CNT_TOTAL];
+    rt_time             cnt_s[RT_CNT_TOTAL];
+
 /*  methods */
 
     rt_void     reset_pseed();
     rt_void     reset_color();
+    rt_void     alloc_buffers();
+
+    rt_time     stamp_prof(rt_si32 phase, rt_time time);
+    rt_void     merge_prof();
+
+    rt_void     reserve_pools();
+    rt_void     release_pools();
+
+    rt_void     update_mt(rt_si32 phase);
+    rt_void     split_tree(rt_Array *arr, rt_si32 size);
+    rt_void     update_tree(rt_time time);
+    rt_void     merge_tiles(rt_si32 index);
+
+    rt_void     update_view();
+    rt_void     update_tiles();
+    rt_void     update_cam();
+    rt_si32     check_cache();
+
+    rt_void     swap_pools();
+    rt_void     flip_pipe();
+
+    rt_si32     render_init();
 
     public:
 
@@ -340,6 +553,13 @@ class rt_Scene : private rt_Registry, public rt_List<rt_Scene>
     rt_void     update(rt_time time, rt_si32 action);
     rt_void     render(rt_time time);
 
+    rt_void     prepare(rt_time time);
+    rt_void     render_post();
+    rt_void     render_wait();
+
+    rt_void     render_cams(rt_time time, rt_si32 num, rt_si32 *cams,
+                            rt_ui32 **frames);
+
     rt_void     update_slice(rt_si32 index, rt_si32 phase);
     rt_void     render_slice(rt_si32 index, rt_si32 phase);
 
@@ -357,14 +577,29 @@ class rt_Scene : private rt_Registry, public rt_List<rt_Scene>
     rt_si32     set_opts(rt_si32 opts);
     rt_si32     get_pton();
     rt_si32     set_pton(rt_si32 pton);
+    rt_si32     get_pipe();
+    rt_si32     set_pipe(rt_si32 pipe);
 
     rt_si32     get_cam_idx();
     rt_si32     next_cam();
     rt_ui32*    get_frame();
     rt_void     save_frame(rt_si32 index);
 
+    rt_PROF*    get_prof(rt_si32 phase);
+    rt_time     get_prof(rt_si32 index, rt_si32 phase);
+    rt_void     reset_prof();
+    rt_void     save_prof(rt_si32 index);
+
+    rt_void     get_mstat(rt_si32 index, rt_MSTAT *mst);
+    rt_size     get_bsize();
+
+    rt_time     get_cnts(rt_si32 counter);
+
+    rt_si32     tune_simd(rt_time time, rt_si32 frms);
+
     rt_Platform*get_platform();
 
+    friend      class rt_Platform;
     friend      class rt_SceneThread;
 };
 
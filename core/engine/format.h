@@ -42,7 +42,8 @@
 #define RT_OPTS_TILING_EXT1     (1 << 2)
 #define RT_OPTS_FSCALE          (1 << 3)
 #define RT_OPTS_TARRAY          (1 << 4)
-#define RT_OPTS_VARRAY          (1 << 5) /* 6 is reserved for future exts */
+#define RT_OPTS_VARRAY          (1 << 5)
+#define RT_OPTS_TILING_EXT2     (1 << 6)
 #define RT_OPTS_ADJUST          (1 << 7)
 #define RT_OPTS_UPDATE          (1 << 8)
 #define RT_OPTS_RENDER          (1 << 9)
@@ -59,6 +60,8 @@
 
 #define RT_OPTS_GAMMA           (1 << 20) /* turns off Gamma when set to 1 */
 #define RT_OPTS_FRESNEL         (1 << 21) /* turns off Fresnel when set to 1 */
+#define RT_OPTS_SHADOW_EXT3     (1 << 22) /* last occluder cache in shadows */
+#define RT_OPTS_STATIC          (1 << 23) /* static scene update caching */
 
 #define RT_OPTS_BUFFERS         (0 << 24) /* prohibits SIMD-buffers if 1 */
 #define RT_OPTS_PT              (1 << 25) /* prohibits path-tracer if 1 */
@@ -88,6 +91,7 @@
         RT_OPTS_THREAD          |                                           \
         RT_OPTS_TILING          |                                           \
         RT_OPTS_TILING_EXT1     |                                           \
+        RT_OPTS_TILING_EXT2     |                                           \
         RT_OPTS_FSCALE          |                                           \
         RT_OPTS_TARRAY          |                                           \
         RT_OPTS_VARRAY          |                                           \
@@ -97,6 +101,8 @@
         RT_OPTS_SHADOW          |                                           \
         RT_OPTS_SHADOW_EXT1     |                                           \
         RT_OPTS_SHADOW_EXT2     |                                           \
+        RT_OPTS_SHADOW_EXT3     |                                           \
+        RT_OPTS_STATIC          |                                           \
         RT_OPTS_2SIDED          |                                           \
         RT_OPTS_2SIDED_EXT1     |                                           \
         RT_OPTS_2SIDED_EXT2     |                                           \
@@ -129,7 +135,8 @@
 #define RT_TAG_PARACYLINDER                 6
 #define RT_TAG_HYPERCYLINDER                7
 #define RT_TAG_HYPERPARABOLOID              8
-#define RT_TAG_SURFACE_MAX                  9
+#define RT_TAG_DISTFIELD                    9
+#define RT_TAG_SURFACE_MAX                  10
 
 /* special tags */
 #define RT_TAG_CAMERA                       100
@@ -169,6 +176,8 @@
 #define RT_REL_BOUND_INDEX                  6 /* add index to bounding volume */
 #define RT_REL_UNTIE_INDEX                  7 /* remove index from bnd volume */
 
+#define RT_REL_LOD_ARRAY                    8 /* array has lod alternate */
+
 struct rt_RELATION
 {
     rt_si32             obj1;
@@ -424,6 +433,8 @@ rt_si32 CM_(rt_CAMERA *pobj)
 /******************************************************************************/
 
 #define RT_LGT_PLAIN                        0
+#define RT_LGT_SPHERE                       1
+#define RT_LGT_RECT                         2
 
 #define RT_LGT(tag)                         RT_LGT_##tag
 
@@ -433,6 +444,7 @@ struct rt_LIGHT
     rt_COL              col;    /* light's color */
     rt_real             lum[2]; /* light's ambient and source intensity */
     rt_real             atn[4]; /* light's attenuation properties */
+    rt_real             ars[2]; /* light's area radius or half-sizes */
 };
 
 static /* needed for strict typization */
@@ -752,6 +764,56 @@ rt_si32 HP_(rt_HYPERPARABOLOID *pobj)
     pmat_outer,             pmat_inner                                      \
 }
 
+/******************************************************************************/
+/*****************************   DISTANCE FIELD   *****************************/
+/******************************************************************************/
+
+/*
+ * Distance field kinds,
+ * sub-fields used by each kind are given in brackets.
+ */
+#define RT_SDF_SPHERE           0 /* sphere (rad) */
+#define RT_SDF_BOX              1 /* rounded box (box, rnd) */
+#define RT_SDF_UNION            2 /* box with sphere (box, rnd, rad, bld) */
+#define RT_SDF_INTERSECT        3 /* box and sphere (box, rnd, rad, bld) */
+#define RT_SDF_SUBTRACT         4 /* box minus sphere (box, rnd, rad, bld) */
+#define RT_SDF_MENGER           5 /* Menger sponge cube (min of box, itr) */
+
+struct rt_DISTFIELD
+{
+    rt_SURFACE          srf;
+    rt_si32             sdf; /* kind of distance field */
+    rt_vec3             box; /* box half-sizes */
+    rt_real             rnd; /* box edge rounding radius */
+    rt_real             rad; /* sphere radius */
+    rt_real             bld; /* blend distance for CSG kinds, 0 - sharp */
+    rt_si32             itr; /* fractal iterations */
+    rt_si32             stp; /* max marching steps, 0 - default */
+    rt_real             eps; /* hit threshold, 0 - default */
+};
+
+static /* needed for strict typization */
+rt_si32 DF_(rt_DISTFIELD *pobj)
+{
+    return RT_TAG_DISTFIELD;
+}
+
+#define RT_OBJ_DISTFIELD(pobj)                                              \
+{                                                                           \
+    DF_(pobj),                                                              \
+    pobj,                   1,                                              \
+    RT_NULL,                0,                                              \
+    RT_NULL,                RT_NULL                                         \
+}
+
+#define RT_OBJ_DISTFIELD_MAT(pobj, pmat_outer, pmat_inner)                  \
+{                                                                           \
+    DF_(pobj),                                                              \
+    pobj,                   1,                                              \
+    RT_NULL,                0,                                              \
+    pmat_outer,             pmat_inner                                      \
+}
+
 /******************************************************************************/
 /**********************************   SCENE   *********************************/
 /******************************************************************************/
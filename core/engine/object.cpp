@@ -97,6 +97,10 @@ rt_Object::rt_Object(rt_Registry *rg, rt_Object *parent, rt_OBJECT *obj)
     this->trnode = RT_NULL;
     this->bvnode = RT_NULL;
 
+    /* reset level-of-detail status */
+    this->lod_off = 0;
+    this->lod_upd = 0;
+
     /* init bvbox used in arrays for outer part of split bvnode if present,
      * used as generic boundary in other objects */
     bvbox = (rt_BOUND *)rg->alloc(RT_IS_SURFACE(this) ?
@@ -177,8 +181,11 @@ rt_void rt_Object::update_status(rt_time time, rt_si32 flags,
 {
     /* animator is called only once for object
      * instances sharing the same scene data,
-     * part of sequential update (phase 0.5)
-     * as the code below is not thread-safe */
+     * phase 0.5 runs subtrees in parallel, but
+     * split_tree keeps all instances of animated
+     * scene data within one subtree (or drops
+     * the split), thus the check below is never
+     * raced by other threads for the same data */
     if (obj->f_anim != RT_NULL && obj->time != time)
     {
         obj->f_anim(time, obj->time < 0 ? 0 : obj->time, trm, RT_NULL);
@@ -186,11 +193,24 @@ rt_void rt_Object::update_status(rt_time time, rt_si32 flags,
 
     /* always update time in scene data to distinguish
      * between first update and all subsequent updates,
-     * even if animator is not present */
-    obj->time = time;
+     * even if animator is not present,
+     * non-animated instances sharing data may be
+     * updated in different subtrees of phase 0.5,
+     * store only if changed, so that once set for
+     * the frame the field is only read by others,
+     * any concurrent stores before that write
+     * the same "time" and nothing in phase 0.5
+     * depends on the old value for such data */
+    if (obj->time != time)
+    {
+        obj->time = time;
+    }
 
-    /* inherit changed status from the hierarchy */
-    obj_changed = (flags & RT_UPDATE_FLAG_OBJ);
+    /* inherit changed status from the hierarchy,
+     * object switched on by level-of-detail is updated
+     * in full along with its sub-objects */
+    obj_changed = (flags & RT_UPDATE_FLAG_OBJ) | lod_upd;
+    lod_upd = 0;
 
     /* update changed status for all object
      * instances sharing the same scene data,
@@ -407,6 +427,15 @@ rt_void rt_Object::update_fields()
 
 }
 
+/*
+ * Return scene data shared by object's instances if it has an animator,
+ * RT_NULL otherwise.
+ */
+rt_OBJECT* rt_Object::get_anim()
+{
+    return obj->f_anim != RT_NULL ? obj : RT_NULL;
+}
+
 /*
  * Deinitialize object.
  */
@@ -619,6 +648,39 @@ rt_Light::rt_Light(rt_Registry *rg, rt_Object *parent, rt_OBJECT *obj) :
     RT_SIMD_SET(s_lgt->a_cnt, lgt->atn[1] + 1.0f);
     RT_SIMD_SET(s_lgt->a_rng, lgt->atn[0]);
 
+    /* per-element strata for area lights use Halton sequence (bases 2, 3),
+     * any prefix of SIMD elements covers the light's area evenly */
+    rt_si32 i, j, n = RT_ARR_SIZE(s_lgt->ofs_u);
+
+    for (i = 0; i < n; i++)
+    {
+        rt_real f, u, v;
+
+        for (j = i + 1, f = 0.5f, u = 0.0f; j > 0; j /= 2, f /= 2.0f)
+        {
+            u += f * (j % 2);
+        }
+        for (j = i + 1, f = 1.0f / 3.0f, v = 0.0f; j > 0; j /= 3, f /= 3.0f)
+        {
+            v += f * (j % 3);
+        }
+
+        s_lgt->ofs_u[i] = u;
+        s_lgt->ofs_v[i] = v;
+    }
+
+    RT_SIMD_SET(s_lgt->hsh_x, 173.371f);
+    RT_SIMD_SET(s_lgt->hsh_y, 293.113f);
+    RT_SIMD_SET(s_lgt->hsh_z, 417.977f);
+    RT_SIMD_SET(s_lgt->hsh_s, 7.31f);
+
+    RT_SIMD_SET(s_lgt->gpc01, (rt_real)RT_PI);
+
+    s_lgt->shp_t[0] = lgt->ars[0] <= 0.0f ? RT_LGT_PLAIN : lgt->tag;
+    s_lgt->shp_t[1] = 0;
+
+    s_lgt->occ_o = 0;
+
     ((rt_Array *)parent)->col.hdr[RT_R] += s_lgt->col_r[0];
     ((rt_Array *)parent)->col.hdr[RT_G] += s_lgt->col_g[0];
     ((rt_Array *)parent)->col.hdr[RT_B] += s_lgt->col_b[0];
@@ -664,6 +726,47 @@ rt_void rt_Light::update_fields()
     RT_SIMD_SET(s_lgt->pos_x, pos[RT_X]);
     RT_SIMD_SET(s_lgt->pos_y, pos[RT_Y]);
     RT_SIMD_SET(s_lgt->pos_z, pos[RT_Z]);
+
+    /* area light axes are taken from light's own transform,
+     * rect spans U and V, sphere spans U, V and W */
+    rt_vec4 u, v, w;
+    rt_real a = lgt->ars[0], b = lgt->ars[1];
+
+    if (s_lgt->shp_t[0] == RT_LGT_SPHERE)
+    {
+        b = a;
+    }
+
+    RT_VEC3_MUL_VAL1(u, mtx[0], a);
+    RT_VEC3_MUL_VAL1(v, mtx[1], b);
+    RT_VEC3_MUL_VAL1(w, mtx[2], a);
+
+    if (s_lgt->shp_t[0] != RT_LGT_SPHERE)
+    {
+        RT_VEC3_SET_VAL1(w, 0.0f);
+    }
+    if (s_lgt->shp_t[0] == RT_LGT_PLAIN)
+    {
+        RT_VEC3_SET_VAL1(u, 0.0f);
+        RT_VEC3_SET_VAL1(v, 0.0f);
+    }
+
+    RT_SIMD_SET(s_lgt->u_x, u[RT_X]);
+    RT_SIMD_SET(s_lgt->u_y, u[RT_Y]);
+    RT_SIMD_SET(s_lgt->u_z, u[RT_Z]);
+
+    RT_SIMD_SET(s_lgt->v_x, v[RT_X]);
+    RT_SIMD_SET(s_lgt->v_y, v[RT_Y]);
+    RT_SIMD_SET(s_lgt->v_z, v[RT_Z]);
+
+    RT_SIMD_SET(s_lgt->w_x, w[RT_X]);
+    RT_SIMD_SET(s_lgt->w_y, w[RT_Y]);
+    RT_SIMD_SET(s_lgt->w_z, w[RT_Z]);
+
+    /* area extent serves as light's bounding radius,
+     * shadow culling stays conservative if non-zero */
+    bvbox->rad = RT_SQRT(RT_VEC3_DOT(u, u) + RT_VEC3_DOT(v, v)
+                       + RT_VEC3_DOT(w, w));
 }
 
 /*
@@ -726,12 +829,10 @@ rt_Node::rt_Node(rt_Registry *rg, rt_Object *parent,
     memset(s_srf, 0, ssize);
     s_srf->srf_t[3] = tag;
 
-    /* allocate SIMD-buffers (with actual number of threads) */
-    if ((rg->opts & RT_OPTS_BUFFERS) == 0)
-    {
-        s_srf->msc_p[0] = rg->alloc(RT_BUFFER_POOL*rg->thr_num, RT_SIMD_ALIGN);
-        memset(s_srf->msc_p[0], 255, RT_BUFFER_POOL*rg->thr_num);
-    }
+    this->ssize = ssize;
+
+    /* SIMD-buffers are allocated by the scene for all nodes at once
+     * after the hierarchy is built, see "alloc_buffers" in engine.cpp */
 
 #if 0 /* surface's misc pointers description */
 
@@ -740,7 +841,7 @@ rt_Node::rt_Node(rt_Registry *rg, rt_Object *parent,
     s_srf->srf_t[2];    /* clip ptr, filled in update0 */
     s_srf->srf_t[3];    /* surf tag */
 
-    s_srf->msc_p[0];    /* SIMD-buffers */
+    s_srf->msc_p[0];    /* SIMD-buffers, filled in alloc_buffers */
     s_srf->msc_p[1];    /* surf flg, filled in update0 */
     s_srf->msc_p[2];    /* custom clippers */
     s_srf->msc_p[3];    /* trnode's simd ptr */
@@ -1192,9 +1293,15 @@ rt_Array::rt_Array(rt_Registry *rg, rt_Object *parent,
     arr_changed = 0;
     scn_changed = 0;
 
+    /* bounds are updated sequentially by default */
+    bnd_upd = 0;
+
     /* reset array's accumulated light */
     memset(&col, 0, sizeof(rt_COL));
 
+    /* reset array's level-of-detail alternate */
+    lod_alt = RT_NULL;
+
     /* init bvbox used for outer part of split bvnode if present */
     if (RT_TRUE)
     {
@@ -1337,6 +1444,10 @@ rt_Array::rt_Array(rt_Registry *rg, rt_Object *parent,
             obj_arr[j] = new(rg) rt_HyperParaboloid(rg, this, &arr[i]);
             break;
 
+            case RT_TAG_DISTFIELD:
+            obj_arr[j] = new(rg) rt_DistField(rg, this, &arr[i]);
+            break;
+
             default:
             j--;
             obj_num--;
@@ -1569,6 +1680,29 @@ rt_Array::rt_Array(rt_Registry *rg, rt_Object *parent,
             }
             break;
 
+            case RT_REL_LOD_ARRAY:
+            if (rel[i].obj1 >= 0 && rel[i].obj2 >= 0
+            &&  RT_IS_ARRAY(obj_arr_l[rel[i].obj1])
+            && (RT_IS_ARRAY(obj_arr_r[rel[i].obj2])
+            ||  RT_IS_SURFACE(obj_arr_r[rel[i].obj2])))
+            {
+                rt_Array *lod = (rt_Array *)obj_arr_l[rel[i].obj1];
+                lod->lod_alt = obj_arr_r[rel[i].obj2];
+                /* full detail is selected until first projection */
+                lod->lod_alt->lod_off = 1;
+            }
+            if (rel[i].obj1 >= 0)
+            {
+                obj_arr_l = obj_arr; /* reset left  sub-array after use */
+                obj_num_l = obj_num;
+            }
+            if (rel[i].obj2 >= 0)
+            {
+                obj_arr_r = obj_arr; /* reset right sub-array after use */
+                obj_num_r = obj_num;
+            }
+            break;
+
             default:
             break;
         }
@@ -1757,18 +1891,60 @@ rt_void rt_Array::update_object(rt_time time, rt_si32 flags,
 
     update_matrix(mtx);
 
-    scn_changed = 0;
+    /* pass array's own transform flags and changed status */
+    sub_flags = flags | mtx_has_trm | obj_changed;
 
     rt_si32 i;
 
-    /* update every object in array including sub-arrays (recursive),
-     * pass array's own transform flags, changed status,
-     * updated trnode and matrix pointer for sub-objects */
+    /* update every object in array including sub-arrays (recursive) */
     for (i = 0; i < obj_num; i++)
     {
-        obj_arr[i]->update_object(time, flags | mtx_has_trm | obj_changed,
-                                  this->trnode, *pmtx);
+        update_sub(obj_arr[i], time);
+    }
+
+    update_changed();
+}
+
+/*
+ * Update array itself with given "time" from its parent array
+ * updated before, without updating its sub-objects.
+ * Used for the hierarchy split in parallel update.
+ */
+rt_void rt_Array::update_array(rt_time time)
+{
+    rt_Array *par = (rt_Array *)parent;
+
+    rt_si32 flags = par != RT_NULL ? par->sub_flags : 0;
+
+    update_status(time, flags, par != RT_NULL ? par->trnode : RT_NULL);
+
+    update_matrix(par != RT_NULL ? *par->pmtx : iden4);
+
+    /* pass array's own transform flags and changed status */
+    sub_flags = flags | mtx_has_trm | obj_changed;
+}
+
+/*
+ * Update sub-object "obj" of the array (and its sub-objects)
+ * with given "time", pass array's transform flags, changed status,
+ * updated trnode and matrix pointer.
+ */
+rt_void rt_Array::update_sub(rt_Object *obj, rt_time time)
+{
+    obj->update_object(time, sub_flags, this->trnode, *pmtx);
+}
+
+/*
+ * Update array's changed status from its sub-objects updated before.
+ */
+rt_void rt_Array::update_changed()
+{
+    rt_si32 i;
 
+    scn_changed = 0;
+
+    for (i = 0; i < obj_num; i++)
+    {
         if (RT_IS_ARRAY(obj_arr[i]))
         {
             scn_changed |= ((rt_Array *)obj_arr[i])->scn_changed;
@@ -1891,11 +2067,23 @@ rt_void rt_Array::update_bounds()
         rt_Node *nd = RT_NULL;
         rt_Array *arr = RT_NULL;
 
+        /* skip sub-objects switched off by level-of-detail,
+         * their bounds are not updated while they are hidden */
+        if (obj_arr[i]->lod_off != 0)
+        {
+            continue;
+        }
+
         if (RT_IS_ARRAY(obj_arr[i]))
         {
             nd = (rt_Node *)obj_arr[i];
             arr = (rt_Array *)nd;
-            arr->update_bounds();
+
+            /* skip sub-arrays already updated in parallel */
+            if (arr->bnd_upd == 0)
+            {
+                arr->update_bounds();
+            }
         }
         else
         if (RT_IS_SURFACE(obj_arr[i]))
@@ -3980,6 +4168,224 @@ rt_HyperParaboloid::~rt_HyperParaboloid()
 
 }
 
+/******************************************************************************/
+/*****************************   DISTANCE FIELD   *****************************/
+/******************************************************************************/
+
+/*
+ * Compute local space half-extents of the distance field "xdf".
+ */
+static
+rt_void df_extent(rt_DISTFIELD *xdf, rt_vec4 ext)
+{
+    rt_real rad = RT_FABS(xdf->rad);
+    rt_real bld = RT_MAX(xdf->bld, 0.0f) * 0.25f;
+    rt_si32 k;
+
+    for (k = 0; k < 3; k++)
+    {
+        rt_real box = RT_FABS(xdf->box[k]);
+
+        switch (xdf->sdf)
+        {
+            case RT_SDF_SPHERE:
+            ext[k] = rad;
+            break;
+
+            case RT_SDF_UNION:
+            ext[k] = RT_MAX(box, rad) + bld;
+            break;
+
+            case RT_SDF_INTERSECT:
+            ext[k] = RT_MIN(box, rad);
+            break;
+
+            case RT_SDF_MENGER:
+            ext[k] = RT_MIN(RT_MIN(RT_FABS(xdf->box[RT_I]),
+                                   RT_FABS(xdf->box[RT_J])),
+                                   RT_FABS(xdf->box[RT_K]));
+            break;
+
+            default:
+            ext[k] = box;
+            break;
+        }
+    }
+
+    ext[RT_L] = RT_SQRT(ext[RT_I] * ext[RT_I] +
+                        ext[RT_J] * ext[RT_J] +
+                        ext[RT_K] * ext[RT_K]);
+}
+
+/*
+ * Instantiate distance field surface object.
+ */
+rt_DistField::rt_DistField(rt_Registry *rg, rt_Object *parent,
+                           rt_OBJECT *obj, rt_si32 ssize) :
+
+    rt_Surface(rg, parent, obj, RT_MAX(ssize, sizeof(rt_SIMD_DISTFIELD)))
+{
+    xdf = (rt_DISTFIELD *)obj->obj.pobj;
+
+    /* init surface's bvbox used for tiling, rtgeom and array's bounds */
+    if (RT_TRUE)
+    {
+        bvbox->verts_num = 8;
+        bvbox->verts = (rt_VERT *)
+                     rg->alloc(bvbox->verts_num * sizeof(rt_VERT), RT_ALIGN);
+
+        bvbox->edges_num = RT_ARR_SIZE(bx_edges);
+        bvbox->edges = (rt_EDGE *)
+                     rg->alloc(bvbox->edges_num * sizeof(rt_EDGE), RT_ALIGN);
+        memcpy(bvbox->edges, bx_edges, bvbox->edges_num * sizeof(rt_EDGE));
+
+        bvbox->faces_num = RT_ARR_SIZE(bx_faces);
+        bvbox->faces = (rt_FACE *)
+                     rg->alloc(bvbox->faces_num * sizeof(rt_FACE), RT_ALIGN);
+        memcpy(bvbox->faces, bx_faces, bvbox->faces_num * sizeof(rt_FACE));
+    }
+}
+
+/*
+ * Update SIMD and other data fields.
+ */
+rt_void rt_DistField::update_fields()
+{
+    if (obj_changed == 0)
+    {
+        return;
+    }
+
+    rt_Surface::update_fields();
+
+    rt_SIMD_DISTFIELD *s_sdf = (rt_SIMD_DISTFIELD *)s_srf;
+
+    rt_vec4 ext, box;
+    rt_si32 k;
+
+    df_extent(xdf, ext);
+
+    /* box sizes follow axis mapping and scaling,
+     * radial sizes use the smallest scaler */
+    rt_real msc = RT_MIN(RT_MIN(scl[RT_X], scl[RT_Y]), scl[RT_Z]);
+
+    box[mp_i] = RT_FABS(xdf->box[RT_I]) * scl[mp_i];
+    box[mp_j] = RT_FABS(xdf->box[RT_J]) * scl[mp_j];
+    box[mp_k] = RT_FABS(xdf->box[RT_K]) * scl[mp_k];
+
+    rt_real bmn = RT_MIN(RT_MIN(box[RT_X], box[RT_Y]), box[RT_Z]);
+    rt_real rnd = RT_MIN(RT_FABS(xdf->rnd) * msc, bmn);
+    rt_real rad = RT_FABS(xdf->rad) * msc;
+    rt_real bld = RT_MAX(xdf->bld, 0.0f) * msc;
+    rt_real eps = xdf->eps > 0.0f ? xdf->eps : RT_SDFE_THRESHOLD;
+
+    rt_si32 itr = RT_MAX(xdf->itr, 1);
+    rt_real fin = bmn;
+
+    for (k = 0; k < itr; k++)
+    {
+        fin /= 3.0f;
+    }
+
+    /* bounding radius for marching limit */
+    ext[mp_i] *= scl[mp_i];
+    ext[mp_j] *= scl[mp_j];
+    ext[mp_k] *= scl[mp_k];
+
+    rt_real brd = RT_SQRT(ext[RT_X] * ext[RT_X] +
+                          ext[RT_Y] * ext[RT_Y] +
+                          ext[RT_Z] * ext[RT_Z]);
+
+    rt_uelm sgn = (rt_uelm)0x80000000 << (RT_ELEMENT - 32);
+
+    RT_SIMD_SET(s_sdf->box_x, box[RT_X] - rnd);
+    RT_SIMD_SET(s_sdf->box_y, box[RT_Y] - rnd);
+    RT_SIMD_SET(s_sdf->box_z, box[RT_Z] - rnd);
+    RT_SIMD_SET(s_sdf->box_r, rnd);
+
+    RT_SIMD_SET(s_sdf->sph_r, rad);
+
+    RT_SIMD_SET(s_sdf->bld_k, bld);
+    RT_SIMD_SET(s_sdf->bld_q, bld > 0.0f ? 0.25f / bld : 0.0f);
+
+    /* CSG kinds are expressed via smooth union:
+     * max(a, b) = -min(-a, -b), max(a, -b) = -min(-a, b) */
+    RT_SIMD_SET(s_sdf->sgn_a, xdf->sdf == RT_SDF_INTERSECT ||
+                              xdf->sdf == RT_SDF_SUBTRACT ? sgn : 0);
+    RT_SIMD_SET(s_sdf->sgn_b, xdf->sdf == RT_SDF_INTERSECT ? sgn : 0);
+
+    RT_SIMD_SET(s_sdf->m_inv, bmn > 0.0f ? 1.0f / bmn : 0.0f);
+    RT_SIMD_SET(s_sdf->m_fin, fin);
+
+    RT_SIMD_SET(s_sdf->h_eps, eps);
+    RT_SIMD_SET(s_sdf->t_off, eps * RT_SDF_OFFSET);
+    RT_SIMD_SET(s_sdf->b_rad, brd);
+    RT_SIMD_SET(s_sdf->n_eps, eps);
+
+    s_sdf->sdf_t[0] = xdf->sdf == RT_SDF_SPHERE ? 0 :
+                      xdf->sdf == RT_SDF_BOX    ? 1 :
+                      xdf->sdf == RT_SDF_MENGER ? 3 : 2;
+    s_sdf->sdf_t[1] = xdf->stp > 0 ? xdf->stp : RT_SDF_STEPS;
+    s_sdf->sdf_t[2] = itr;
+
+    /* rtgeom sees the field as its bounding ellipsoid,
+     * surface side inside of it is undetermined */
+    shape->sci[RT_X] = 1.0f / (scl[RT_X] * scl[RT_X]);
+    shape->sci[RT_Y] = 1.0f / (scl[RT_Y] * scl[RT_Y]);
+    shape->sci[RT_Z] = 1.0f / (scl[RT_Z] * scl[RT_Z]);
+    shape->sci[RT_W] = ext[RT_L] * ext[RT_L];
+
+    RT_VEC3_SET_VAL1(shape->scj, 0.0f);
+    shape->scj[RT_W] = 0.0f;
+
+    RT_VEC3_SET_VAL1(shape->sck, 0.0f);
+    shape->sck[RT_W] = 0.0f;
+}
+
+/*
+ * Adjust local space bounding and clipping boxes according to surface shape.
+ */
+rt_void rt_DistField::adjust_minmax(rt_vec4 smin, rt_vec4 smax, /* src */
+                                    rt_vec4 bmin, rt_vec4 bmax, /* bbox */
+                                    rt_vec4 cmin, rt_vec4 cmax) /* cbox */
+{
+    rt_Surface::adjust_minmax(smin, smax, bmin, bmax, cmin, cmax);
+
+    rt_vec4 ext;
+
+    df_extent(xdf, ext);
+
+    if (cmin != RT_NULL && cmax != RT_NULL)
+    {
+        cmin[RT_I] = cmin[RT_I] <= -ext[RT_I] ? -RT_INF : cmin[RT_I];
+        cmin[RT_J] = cmin[RT_J] <= -ext[RT_J] ? -RT_INF : cmin[RT_J];
+        cmin[RT_K] = cmin[RT_K] <= -ext[RT_K] ? -RT_INF : cmin[RT_K];
+
+        cmax[RT_I] = cmax[RT_I] >= +ext[RT_I] ? +RT_INF : cmax[RT_I];
+        cmax[RT_J] = cmax[RT_J] >= +ext[RT_J] ? +RT_INF : cmax[RT_J];
+        cmax[RT_K] = cmax[RT_K] >= +ext[RT_K] ? +RT_INF : cmax[RT_K];
+    }
+
+    if (bmin != RT_NULL && bmax != RT_NULL)
+    {
+        bmin[RT_I] = RT_MAX(smin[RT_I], -ext[RT_I]);
+        bmin[RT_J] = RT_MAX(smin[RT_J], -ext[RT_J]);
+        bmin[RT_K] = RT_MAX(smin[RT_K], -ext[RT_K]);
+
+        bmax[RT_I] = RT_MIN(smax[RT_I], +ext[RT_I]);
+        bmax[RT_J] = RT_MIN(smax[RT_J], +ext[RT_J]);
+        bmax[RT_K] = RT_MIN(smax[RT_K], +ext[RT_K]);
+    }
+}
+
+/*
+ * Deinitialize distance field surface object.
+ */
+rt_DistField::~rt_DistField()
+{
+
+}
+
 /******************************************************************************/
 /********************************   MATERIAL   ********************************/
 /******************************************************************************/
@@ -40,6 +40,13 @@
 
 #define RT_DEPS_THRESHOLD       0.00000000001f /* <- maximum for two-plane */
 #define RT_TEPS_THRESHOLD       0.0000001f /* <- minimum for roots sorting */
+#define RT_SDFE_THRESHOLD       0.001f /* <- default hit for distance field */
+
+/*
+ * Distance field marching defaults.
+ */
+#define RT_SDF_STEPS            96 /* max marching steps per ray */
+#define RT_SDF_OFFSET           8.0f /* self-hit start offset in thresholds */
 
 /*
  * Camera actions.
@@ -102,6 +109,7 @@ class rt_Hyperboloid;
 class rt_ParaCylinder;
 class rt_HyperCylinder;
 class rt_HyperParaboloid;
+class rt_DistField;
 
 class rt_Texture;
 class rt_Material;
@@ -270,6 +278,17 @@ class rt_Object
      * its own bounding volume */
     rt_Object          *bvnode;
 
+    /* non-zero if object is switched off
+     * by level-of-detail selection,
+     * which also hides its sub-objects */
+    rt_si32             lod_off;
+
+    /* non-zero if object is switched on
+     * by level-of-detail selection,
+     * as its sub-objects were skipped
+     * in update while switched off */
+    rt_si32             lod_upd;
+
 /*  methods */
 
     protected:
@@ -298,6 +317,8 @@ class rt_Object
                           rt_Object *trnode, rt_mat4 mtx);
     virtual
     rt_void update_fields();
+
+    rt_OBJECT *get_anim();
 };
 
 /******************************************************************************/
@@ -408,6 +429,9 @@ class rt_Node : public rt_Object
     /* surface SIMD struct,
      * used for trnode if present */
     rt_SIMD_SURFACE    *s_srf;
+    /* size of SIMD struct above,
+     * same for array's s_inb/s_bvb */
+    rt_si32             ssize;
 
 /*  methods */
 
@@ -472,6 +496,14 @@ class rt_Array : public rt_Node, public rt_List<rt_Array>
      * some of its sub-objects changed */
     rt_si32             scn_changed;
 
+    /* transform flags and changed status
+     * passed to sub-objects in update */
+    rt_si32             sub_flags;
+
+    /* non-zero if array's bounds were updated
+     * in parallel part of phase 2.5 (see engine) */
+    rt_si32             bnd_upd;
+
     /* cumulative luminosity
      * of all lights in array */
     rt_COL              col;
@@ -496,6 +528,11 @@ class rt_Array : public rt_Node, public rt_List<rt_Array>
      * used for bvbox part of bvnode */
     rt_SIMD_SURFACE    *s_bvb;
 
+    /* level-of-detail alternate,
+     * rendered instead of array's contents
+     * when their projected size is small */
+    rt_Object          *lod_alt;
+
 /*  methods */
 
     protected:
@@ -524,6 +561,10 @@ class rt_Array : public rt_Node, public rt_List<rt_Array>
     rt_void update_fields();
 
     rt_void update_bounds();
+
+    rt_void update_array(rt_time time);
+    rt_void update_sub(rt_Object *obj, rt_time time);
+    rt_void update_changed();
 };
 
 /******************************************************************************/
@@ -558,6 +599,15 @@ class rt_Surface : public rt_Node, public rt_List<rt_Surface>
     /* tiles list in framebuffer
      * prepared for rendering */
     rt_ELEM            *tls;
+    /* row index into tiles list,
+     * first element of each row
+     * in tile-rect plus list's end */
+    rt_ELEM           **tlr;
+
+    /* projected tile-rect in framebuffer
+     * as xmin, ymin, xmax, ymax (inclusive),
+     * used for level-of-detail selection */
+    rt_si32             tbx[4];
 
     /* surface shape extension to
      * bounding box and volume */
@@ -964,6 +1014,42 @@ class rt_HyperParaboloid : public rt_Quadric
     rt_void update_fields();
 };
 
+/******************************************************************************/
+/*****************************   DISTANCE FIELD   *****************************/
+/******************************************************************************/
+
+/*
+ * Distance field is a non-algebraic surface rendered via sphere tracing.
+ */
+class rt_DistField : public rt_Surface
+{
+/*  fields */
+
+    private:
+
+    rt_DISTFIELD       *xdf;
+
+/*  methods */
+
+    protected:
+
+    virtual
+    rt_void adjust_minmax(rt_vec4 smin, rt_vec4 smax,  /* src */
+                          rt_vec4 bmin, rt_vec4 bmax,  /* bbox */
+                          rt_vec4 cmin, rt_vec4 cmax); /* cbox */
+
+    public:
+
+    rt_DistField(rt_Registry *rg, rt_Object *parent, rt_OBJECT *obj,
+                 rt_si32 ssize = 0);
+
+    virtual
+   ~rt_DistField();
+
+    virtual
+    rt_void update_fields();
+};
+
 /******************************************************************************/
 /********************************   MATERIAL   ********************************/
 /******************************************************************************/
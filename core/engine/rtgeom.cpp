@@ -722,7 +722,8 @@ rt_si32 surf_conc(rt_SHAPE *srf)
     if (srf->tag == RT_TAG_CONE
     ||  srf->tag == RT_TAG_HYPERBOLOID
     ||  srf->tag == RT_TAG_HYPERCYLINDER
-    ||  srf->tag == RT_TAG_HYPERPARABOLOID)
+    ||  srf->tag == RT_TAG_HYPERPARABOLOID
+    ||  srf->tag == RT_TAG_DISTFIELD)
     {
         c = 1;
     }
@@ -756,7 +757,8 @@ rt_si32 clip_conc(rt_SHAPE *srf)
     {
         c = 1;
     }
-    if (srf->tag == RT_TAG_HYPERPARABOLOID)
+    if (srf->tag == RT_TAG_HYPERPARABOLOID
+    ||  srf->tag == RT_TAG_DISTFIELD)
     {
         c = 1;
     }
@@ -920,6 +922,13 @@ rt_si32 surf_side(rt_SHAPE *srf, rt_vec4 pos)
         d = dci - dcj - srf->sci[RT_W];
     }
 
+    /* distance field is represented by its bounding ellipsoid,
+     * any point inside is treated as being on the surface */
+    if (srf->tag == RT_TAG_DISTFIELD)
+    {
+        d = d > 0.0f ? d : 0.0f;
+    }
+
     /*    inner   | s |   outer    */
     /* -----------|-*-|----------- */
     /*      1     | 0 |     2      */
@@ -993,6 +1002,51 @@ rt_si32 clip_side(rt_SHAPE *srf, rt_vec4 pos)
     return c;
 }
 
+/*
+ * Determine if "nd1's" bounding sphere lies outside of the capsule
+ * enclosing all shadow rays between "obj's" and "nd2's" bounding spheres.
+ * Serves as a cheap broad-phase test in front of "bbox_shad",
+ * as it only needs a point-segment distance without trigonometry.
+ *
+ * Return values:
+ *   0 - no (or unknown)
+ *   1 - yes, "nd1" can't cast shadow on "nd2"
+ */
+rt_si32 bbox_span(rt_BOUND *obj, rt_BOUND *nd1, rt_BOUND *nd2)
+{
+    /* check if nodes differ and have bounds */
+    if (obj->rad == RT_INF || nd1->rad == RT_INF || nd2->rad == RT_INF
+    ||  nd1 == nd2)
+    {
+        return 0;
+    }
+
+    /* segment from light's "pos" towards "nd2's" center */
+    rt_vec4 seg_vec;
+    RT_VEC3_SUB(seg_vec, nd2->mid, obj->mid);
+    rt_real seg_dot = RT_VEC3_DOT(seg_vec, seg_vec);
+
+    rt_vec4 nd1_vec;
+    RT_VEC3_SUB(nd1_vec, nd1->mid, obj->mid);
+    rt_real nd1_dot = RT_VEC3_DOT(nd1_vec, seg_vec);
+
+    /* find the closest point on the segment to "nd1's" center */
+    rt_real t = seg_dot <= 0.0f ? 0.0f : nd1_dot / seg_dot;
+    t = RT_MAX(0.0f, RT_MIN(t, 1.0f));
+
+    RT_VEC3_MAD_VAL1(nd1_vec, seg_vec, -t);
+
+    /* capsule's radius covers both light's extent and "nd2's" sphere */
+    rt_real rad = nd1->rad + RT_MAX(obj->rad, nd2->rad);
+
+    if (RT_VEC3_DOT(nd1_vec, nd1_vec) > rad * rad)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
 /*
  * Determine if "nd1's" bbox casts shadow on "nd2's" bbox
  * as seen from "obj's" bbox "mid" (light's "pos").
@@ -1012,6 +1066,11 @@ rt_si32 bbox_shad(rt_BOUND *obj, rt_BOUND *nd1, rt_BOUND *nd2)
     rt_real *pps = obj->mid;
     rt_si32 i, j, k;
 
+    /* area lights are handled by inflating nodes' bounding spheres
+     * with light's extent, which is equivalent to moving the light */
+    rt_real nd1_rad = nd1->rad + obj->rad;
+    rt_real nd2_rad = nd2->rad + obj->rad;
+
     /* check if "nd1" and "nd2" is SURFACE
      * and clip relations for shadow optimization is enabled in runtime */
 #if RT_OPTS_SHADOW_EXT2 != 0
@@ -1044,12 +1103,12 @@ rt_si32 bbox_shad(rt_BOUND *obj, rt_BOUND *nd1, rt_BOUND *nd2)
     rt_real dff_ang = RT_VEC3_DOT(nd1_vec, nd2_vec);
 
     dff_ang = nd1_len <= RT_CULL_THRESHOLD ? 0.0f : dff_ang / nd1_len;
-    rt_real nd1_ang = nd1_len >= nd1->rad && nd1_len > RT_CULL_THRESHOLD ?
-                        RT_ASIN(nd1->rad / nd1_len) : (rt_real)RT_2_PI;
+    rt_real nd1_ang = nd1_len >= nd1_rad && nd1_len > RT_CULL_THRESHOLD ?
+                        RT_ASIN(nd1_rad / nd1_len) : (rt_real)RT_2_PI;
 
     dff_ang = nd2_len <= RT_CULL_THRESHOLD ? 0.0f : dff_ang / nd2_len;
-    rt_real nd2_ang = nd2_len >= nd2->rad && nd2_len > RT_CULL_THRESHOLD ?
-                        RT_ASIN(nd2->rad / nd2_len) : (rt_real)RT_2_PI;
+    rt_real nd2_ang = nd2_len >= nd2_rad && nd2_len > RT_CULL_THRESHOLD ?
+                        RT_ASIN(nd2_rad / nd2_len) : (rt_real)RT_2_PI;
 
     dff_ang = RT_ACOS(dff_ang);
 
@@ -1064,17 +1123,18 @@ rt_si32 bbox_shad(rt_BOUND *obj, rt_BOUND *nd1, rt_BOUND *nd2)
     rt_real dff_len = RT_VEC3_LEN(dff_vec);
 
     /* check if shadow bounding sphere is fully behind */
-    if (nd1->rad + nd2->rad < dff_len
+    if (nd1_rad + nd2_rad < dff_len
     &&  nd1_len > nd2_len)
     {
         return 0;
     }
 
     /* check if nodes don't have bounding boxes
-     * or bbox relations for shadow optimization is disabled in runtime */
+     * or bbox relations for shadow optimization is disabled in runtime,
+     * bbox relations below assume point light */
 #if RT_OPTS_SHADOW_EXT1 != 0
     if ((*obj->opts & RT_OPTS_SHADOW_EXT1) == 0
-    ||  nd1->verts_num == 0 || nd2->verts_num == 0)
+    ||  nd1->verts_num == 0 || nd2->verts_num == 0 || obj->rad > 0.0f)
 #endif /* RT_OPTS_SHADOW_EXT1 */
     {
         return 1;
@@ -318,6 +318,16 @@ struct rt_SHAPE : public rt_BOUND
     rt_pntr            *ptr;
 };
 
+/*
+ * Determine if "nd1's" bounding sphere lies outside of the capsule
+ * enclosing all shadow rays between "obj's" and "nd2's" bounding spheres.
+ *
+ * Return values:
+ *   0 - no (or unknown)
+ *   1 - yes, "nd1" can't cast shadow on "nd2"
+ */
+rt_si32 bbox_span(rt_BOUND *obj, rt_BOUND *nd1, rt_BOUND *nd2);
+
 /*
  * Determine if "nd1's" bbox casts shadow on "nd2's" bbox
  * as seen from "obj's" bbox "mid" (light's "pos").
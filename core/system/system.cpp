@@ -8,6 +8,12 @@
 #include <stdio.h>
 #endif /* RT_EMBED_STDOUT */
 
+#if   (defined RT_WIN32) || (defined RT_WIN64)
+#include <windows.h>
+#elif (defined RT_LINUX)
+#include <time.h>
+#endif /* ------------- OS specific ----------------------------------------- */
+
 #include "system.h"
 
 /******************************************************************************/
@@ -18,7 +24,8 @@
  * system.cpp: Implementation of the system layer.
  *
  * System layer of the engine responsible for file I/O operations,
- * fast linear memory heap allocations, error and info logging
+ * fast linear memory heap allocations, error and info logging,
+ * high-resolution timing for profiling
  * as well as definitions of List template and Exception classes.
  */
 
@@ -153,6 +160,14 @@ rt_Heap::rt_Heap(rt_FUNC_ALLOC f_alloc, rt_FUNC_FREE f_free)
     /* init heap */
     head = RT_NULL;
     obj_head = RT_NULL;
+    trace = RT_NULL;
+
+    /* init memory accounting */
+    mem_cmt = 0;
+    mem_tail = 0;
+    mem_peak = 0;
+    chk_num = 0;
+
     chunk_alloc(0, RT_ALIGN);
 }
 
@@ -181,6 +196,14 @@ rt_void rt_Heap::chunk_alloc(rt_size size, rt_ui32 align)
     chunk->size = real_size;
     chunk->next = head;
 
+    /* account for the new chunk and the one it hides */
+    if (head != RT_NULL)
+    {
+        mem_tail += head->ptr - (rt_byte *)(head + 1);
+    }
+    mem_cmt += real_size;
+    chk_num++;
+
     head = chunk;
 }
 
@@ -190,18 +213,44 @@ rt_void rt_Heap::chunk_alloc(rt_size size, rt_ui32 align)
  */
 rt_pntr rt_Heap::alloc(rt_size size, rt_ui32 align)
 {
-    rt_byte *ptr = (rt_byte *)reserve(size, align);
+    rt_byte *ptr = (rt_byte *)chunk_reserve(size, align);
 
     head->ptr = ptr + size;
 
+    rt_size live = mem_tail + (head->ptr - (rt_byte *)(head + 1));
+    mem_peak = RT_MAX(mem_peak, live);
+
     return ptr;
 }
 
 /*
  * Reserve given "size" bytes of memory with given "align",
  * don't move heap pointer. Next alloc will begin in reserved area.
+ * Only explicit reserves are traced, not the ones from allocs.
  */
 rt_pntr rt_Heap::reserve(rt_size size, rt_ui32 align)
+{
+    rt_time time = trace != RT_NULL ? get_usec() : 0;
+
+    rt_byte *ptr = (rt_byte *)chunk_reserve(size, align);
+
+    /* reserved area counts towards high-water */
+    rt_size live = mem_tail + (ptr + size - (rt_byte *)(head + 1));
+    mem_peak = RT_MAX(mem_peak, live);
+
+    if (trace != RT_NULL)
+    {
+        trace_event(trace, "heap reserve", time, get_usec() - time, size);
+    }
+
+    return ptr;
+}
+
+/*
+ * Reserve given "size" bytes of memory with given "align" in current chunk,
+ * allocate new chunk if it doesn't fit. Heap pointer is only moved to align.
+ */
+rt_pntr rt_Heap::chunk_reserve(rt_size size, rt_ui32 align)
 {
     /* compute align */
     rt_size mask = align > 0 ? align - 1 : 0;
@@ -228,6 +277,8 @@ rt_pntr rt_Heap::reserve(rt_size size, rt_ui32 align)
  */
 rt_pntr rt_Heap::release(rt_pntr ptr)
 {
+    rt_time time = trace != RT_NULL ? get_usec() : 0;
+
     /* search chunk where "ptr" belongs,
      * free chunks allocated afterwards */
     while (head != RT_NULL && (ptr < head + 1 || ptr >= head->end))
@@ -251,8 +302,16 @@ rt_pntr rt_Heap::release(rt_pntr ptr)
 
         /* release chunk */
         rt_CHUNK *chunk = head->next;
+        mem_cmt -= head->size;
+        chk_num--;
         f_free(head, head->size);
         head = chunk;
+
+        /* previous chunk becomes the head again */
+        if (head != RT_NULL)
+        {
+            mem_tail -= head->ptr - (rt_byte *)(head + 1);
+        }
     }
 
     /* reset heap pointer to "ptr" */
@@ -275,6 +334,12 @@ rt_pntr rt_Heap::release(rt_pntr ptr)
             obj = (rt_pntr *)*obj;
         }
 
+        if (trace != RT_NULL)
+        {
+            trace_event(trace, "heap release", time, get_usec() - time,
+                head->ptr > ptr ? (rt_size)(head->ptr - (rt_byte *)ptr) : 0);
+        }
+
         /* reset heap pointer */
         head->ptr = (rt_byte *)ptr;
         return ptr;
@@ -320,10 +385,13 @@ rt_pntr rt_Heap::obj_alloc(rt_size size, rt_ui32 align)
         obj = (rt_pntr *)*obj;
     }
 
-    rt_byte *ptr = (rt_byte *)reserve(size + RT_MAX(8, align), align);
+    rt_byte *ptr = (rt_byte *)chunk_reserve(size + RT_MAX(8, align), align);
 
     head->ptr = ptr + size + RT_MAX(8, align);
 
+    rt_size live = mem_tail + (head->ptr - (rt_byte *)(head + 1));
+    mem_peak = RT_MAX(mem_peak, live);
+
     ptr += RT_MAX(8, align);
 
     *((rt_si32 *)ptr - 1) = size;      /* size behind pointer */
@@ -353,6 +421,62 @@ rt_pntr rt_Heap::obj_free(rt_pntr ptr)
     return RT_NULL;
 }
 
+/*
+ * Get heap's memory accounting (see rt_MSTAT).
+ */
+rt_void rt_Heap::get_mstat(rt_MSTAT *mst)
+{
+    mst->cmt = mem_cmt;
+    mst->live = mem_tail +
+                (head != RT_NULL ? head->ptr - (rt_byte *)(head + 1) : 0);
+    mst->peak = RT_MAX(mem_peak, mst->live);
+    mst->chunks = chk_num;
+}
+
+/*
+ * Reset heap's high-water to currently live memory,
+ * call at the beginning of a frame to track per-frame high-water.
+ */
+rt_void rt_Heap::reset_mstat()
+{
+    mem_peak = mem_tail +
+               (head != RT_NULL ? head->ptr - (rt_byte *)(head + 1) : 0);
+}
+
+/*
+ * Exchange memory chunks (with allocations in them) and accounting
+ * with another heap "hp", allocation functions and trace ring are kept.
+ * Used to alternate heaps between frames which are in flight together.
+ */
+rt_void rt_Heap::swap(rt_Heap *hp)
+{
+    rt_CHUNK *chunk = head;
+    head = hp->head;
+    hp->head = chunk;
+
+    rt_pntr obj = obj_head;
+    obj_head = hp->obj_head;
+    hp->obj_head = obj;
+
+    rt_size size;
+
+    size = mem_cmt;
+    mem_cmt = hp->mem_cmt;
+    hp->mem_cmt = size;
+
+    size = mem_tail;
+    mem_tail = hp->mem_tail;
+    hp->mem_tail = size;
+
+    size = mem_peak;
+    mem_peak = hp->mem_peak;
+    hp->mem_peak = size;
+
+    rt_si32 num = chk_num;
+    chk_num = hp->chk_num;
+    hp->chk_num = num;
+}
+
 /*
  * Deinitialize heap.
  */
@@ -374,6 +498,55 @@ rt_Heap::~rt_Heap()
     }
 }
 
+/******************************************************************************/
+/**********************************   TIMER   *********************************/
+/******************************************************************************/
+
+/*
+ * Get monotonic system time in microseconds.
+ * Returns 0 if high-resolution timer is not available on the platform.
+ */
+rt_time get_usec()
+{
+#if   (defined RT_WIN32) || (defined RT_WIN64)
+    LARGE_INTEGER fr;
+    QueryPerformanceFrequency(&fr);
+    LARGE_INTEGER tm;
+    QueryPerformanceCounter(&tm);
+    return (rt_time)(tm.QuadPart / fr.QuadPart * 1000000
+                  + (tm.QuadPart % fr.QuadPart) * 1000000 / fr.QuadPart);
+#elif (defined RT_LINUX)
+    timespec tm;
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+    return (rt_time)tm.tv_sec * 1000000 + tm.tv_nsec / 1000;
+#else /* ------------- OS specific ----------------------------------------- */
+    return 0;
+#endif /* ------------- OS specific ----------------------------------------- */
+}
+
+/*
+ * Record event into given trace ring (ignored if RT_NULL),
+ * "name" must be a static string as it isn't copied.
+ * Each ring must only be written by a single thread at a time.
+ */
+rt_void trace_event(rt_TRACE *trc, rt_pstr name,
+                    rt_time time, rt_time dur, rt_size arg)
+{
+    if (trc == RT_NULL)
+    {
+        return;
+    }
+
+    rt_EVENT *evt = &trc->evts[trc->cnt % trc->size];
+
+    evt->name = name;
+    evt->time = time;
+    evt->dur  = dur;
+    evt->arg  = arg;
+
+    trc->cnt++;
+}
+
 /******************************************************************************/
 /*********************************   LOGGING   ********************************/
 /******************************************************************************/
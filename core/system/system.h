@@ -37,6 +37,7 @@
 #define RT_PATH_DUMP            RT_PATH_TOSTR(RT_PATH)"dump/"
 #define RT_PATH_DUMP_LOG        RT_PATH_TOSTR(RT_PATH)"dump/log.txt"
 #define RT_PATH_DUMP_ERR        RT_PATH_TOSTR(RT_PATH)"dump/err.txt"
+#define RT_PATH_DUMP_SIMD       RT_PATH_TOSTR(RT_PATH)"dump/simd.bin"
 
 /* Classes */
 
@@ -98,6 +99,39 @@ struct rt_CHUNK
     rt_CHUNK           *next;
 };
 
+/*
+ * Trace event recorded into a ring buffer, times in microseconds.
+ */
+struct rt_EVENT
+{
+    rt_pstr             name;   /* static string, not copied */
+    rt_time             time;   /* start timestamp from get_usec */
+    rt_time             dur;    /* duration (< 0 - instant event) */
+    rt_size             arg;    /* event-specific value (size in bytes) */
+};
+
+/*
+ * Trace ring buffer for events recorded by a single thread,
+ * new events overwrite the oldest ones once the ring is full.
+ */
+struct rt_TRACE
+{
+    rt_EVENT           *evts;
+    rt_si32             size;   /* ring capacity in events */
+    rt_time             cnt;    /* total number of recorded events */
+};
+
+/*
+ * Heap memory accounting, sizes in bytes.
+ */
+struct rt_MSTAT
+{
+    rt_size             cmt;    /* committed in chunks (from f_alloc) */
+    rt_size             live;   /* in use up to heap pointer (incl. free objs) */
+    rt_size             peak;   /* high-water of live/reserved since reset */
+    rt_si32             chunks; /* number of chunks */
+};
+
 /*
  * Memory alloc/free function types.
  */
@@ -117,13 +151,26 @@ class rt_Heap
     rt_CHUNK           *head;
     rt_pntr             obj_head;
 
+    /* memory accounting */
+    rt_size             mem_cmt;
+    rt_size             mem_tail; /* live bytes in chunks behind the head */
+    rt_size             mem_peak;
+    rt_si32             chk_num;
+
     rt_void chunk_alloc(rt_size size, rt_ui32 align);
+    rt_pntr chunk_reserve(rt_size size, rt_ui32 align);
 
     protected:
 
     rt_FUNC_ALLOC       f_alloc;
     rt_FUNC_FREE        f_free;
 
+    public:
+
+    /* trace ring for reserve/release
+     * events (RT_NULL - tracing is off) */
+    rt_TRACE           *trace;
+
 /*  methods */
 
     public:
@@ -139,6 +186,11 @@ class rt_Heap
 
     rt_pntr obj_alloc(rt_size size, rt_ui32 align);
     rt_pntr obj_free(rt_pntr ptr);
+
+    rt_void get_mstat(rt_MSTAT *mst);
+    rt_void reset_mstat();
+
+    rt_void swap(rt_Heap *hp);
 };
 
 /******************************************************************************/
@@ -190,6 +242,21 @@ class rt_Exception
    ~rt_Exception() { }
 };
 
+/******************************************************************************/
+/**********************************   TIMER   *********************************/
+/******************************************************************************/
+
+/*
+ * Get monotonic system time in microseconds (0 if not supported).
+ */
+rt_time get_usec();
+
+/*
+ * Record event into given trace ring (ignored if RT_NULL).
+ */
+rt_void trace_event(rt_TRACE *trc, rt_pstr name,
+                    rt_time time, rt_time dur, rt_size arg);
+
 /******************************************************************************/
 /*********************************   LOGGING   ********************************/
 /******************************************************************************/
@@ -57,6 +57,8 @@
 #define RT_FEAT_LIGHTS_COLORED      1
 #define RT_FEAT_LIGHTS_AMBIENT      1
 #define RT_FEAT_LIGHTS_SHADOWS      1
+#define RT_FEAT_LIGHTS_SHADOWS_OCC  1   /* test last occluder first if 1 */
+#define RT_FEAT_LIGHTS_AREA         1   /* sample area lights if 1 */
 #define RT_FEAT_LIGHTS_DIFFUSE      1
 #define RT_FEAT_LIGHTS_ATTENUATION  1
 #define RT_FEAT_LIGHTS_SPECULAR     1
@@ -126,7 +128,7 @@
 #define FLG   0x04 /* LOCAL, PARAM, MAT_P, MSC_P, XMISC */
 #define SRF   0x04 /* LST_P, SRF_T */
 
-#define LST   0x08 /* LOCAL, PARAM */
+#define LST   0x08 /* LOCAL, PARAM, XMISC */
 #define CLP   0x08 /* MSC_P, SRF_T */
 
 #define OBJ   0x0C /* LOCAL, PARAM, MSC_P */
@@ -566,6 +568,58 @@
                  EQ_x, lo)                                                  \
     LBL(100501)
 
+/*
+ * Load current tile's address in tilebuffer as occluder cache's tag.
+ */
+#if RT_FEAT_TILING
+
+#define TILE_OCCL(RG) /* destroys RG */                                     \
+        movxx_ld(W(RG), Mebp, inf_TLS_X)                                    \
+        shlxx_ri(W(RG), IB(1+P))                                            \
+        addxx_ld(W(RG), Mebp, inf_TLS)
+
+#else /* RT_FEAT_TILING */
+
+#define TILE_OCCL(RG) /* destroys RG */                                     \
+        movxx_ri(W(RG), IB(0))
+
+#endif /* RT_FEAT_TILING */
+
+/*
+ * Store current surface into thread's occluder cache (if enabled)
+ * for the light of current shadow list, tagged with the list and the tile,
+ * to be tested first for subsequent shadow rays from the same list
+ * within the same tile. Only surfaces not relying on their trnode's
+ * transform caching are stored, as the cache is tested outside
+ * of the trnode's sub-list.
+ */
+#if RT_FEAT_LIGHTS_SHADOWS_OCC
+
+#define STORE_OCCL() /* destroys Reax, Redi */                              \
+        cmjxx_mz(Mebp, inf_OCC,                                             \
+                 EQ_x, 100506f)                                             \
+        cmjxx_mz(Mebx, srf_MSC_P(OBJ),                                      \
+                 EQ_x, 100505f)                                             \
+        cmjxx_rm(Rebx, Mebx, srf_MSC_P(OBJ),                                \
+                 NE_x, 100506f)                                             \
+    LBL(100505)                                                             \
+        movxx_ld(Redi, Mecx, ctx_PARAM(LST))                                \
+        movxx_ld(Reax, Medi, elm_DATA)                                      \
+        movxx_ld(Redi, Medi, elm_SIMD)                                      \
+        movxx_ld(Redi, Medi, lgt_OCC_O)                                     \
+        addxx_ld(Redi, Mebp, inf_OCC)                                       \
+        movxx_st(Reax, Medi, elm_NEXT)                                      \
+        movxx_st(Rebx, Medi, elm_SIMD)                                      \
+        TILE_OCCL(Reax)                                                     \
+        movxx_st(Reax, Medi, elm_TEMP)                                      \
+    LBL(100506)
+
+#else /* RT_FEAT_LIGHTS_SHADOWS_OCC */
+
+#define STORE_OCCL()
+
+#endif /* RT_FEAT_LIGHTS_SHADOWS_OCC */
+
 /*
  * Check if ray is a shadow ray, then check
  * material properties to see if shadow is applicable.
@@ -573,7 +627,7 @@
  * check if all rays within SIMD are already in the shadow,
  * if so skip the rest of the shadow list.
  */
-#define CHECK_SHAD(lb) /* destroys Reax, Xmm7 */                            \
+#define CHECK_SHAD(lb) /* destroys Reax, Redi, Xmm7 */                      \
         CHECK_FLAG(100501f, PARAM, RT_FLAG_SHAD)                            \
         CHECK_PROP(100502f, RT_PROP_LIGHT)                                  \
         movwx_ld(Reax, Mecx, ctx_LOCAL(PTR))                                \
@@ -585,6 +639,10 @@
                  EQ_x, 510134b) /* SR_rt4 */                                \
         cmjwx_ri(Reax, IB(6),                                               \
                  EQ_x, 510136b) /* SR_rt6 */                                \
+        cmjwx_ri(Reax, IB(13),                                              \
+                 EQ_x, 5101313b) /* SR_rt13 */                              \
+        cmjwx_ri(Reax, IB(14),                                              \
+                 EQ_x, 5101314b) /* SR_rt14 */                              \
     LBL(100502)                                                             \
         CHECK_PROP(100503f, RT_PROP_TRANSP)                                 \
         CHECK_PROP(100504f, RT_PROP_REFRACT)                                \
@@ -599,10 +657,15 @@
                  EQ_x, 510134b) /* SR_rt4 */                                \
         cmjwx_ri(Reax, IB(6),                                               \
                  EQ_x, 510136b) /* SR_rt6 */                                \
+        cmjwx_ri(Reax, IB(13),                                              \
+                 EQ_x, 5101313b) /* SR_rt13 */                              \
+        cmjwx_ri(Reax, IB(14),                                              \
+                 EQ_x, 5101314b) /* SR_rt14 */                              \
     LBL(100503)                                                             \
         movpx_ld(Xmm7, Mecx, ctx_C_BUF(0))                                  \
         orrpx_ld(Xmm7, Mecx, ctx_TMASK(0))                                  \
         movpx_st(Xmm7, Mecx, ctx_C_BUF(0))                                  \
+        STORE_OCCL()                                                        \
         CHECK_MASK(990923f, FULL, Xmm7)         /* OO_out */                \
         movwx_ld(Reax, Mecx, ctx_LOCAL(PTR))                                \
         cmjwx_ri(Reax, IB(1),                                               \
@@ -613,6 +676,10 @@
                  EQ_x, 510134b) /* SR_rt4 */                                \
         cmjwx_ri(Reax, IB(6),                                               \
                  EQ_x, 510136b) /* SR_rt6 */                                \
+        cmjwx_ri(Reax, IB(13),                                              \
+                 EQ_x, 5101313b) /* SR_rt13 */                              \
+        cmjwx_ri(Reax, IB(14),                                              \
+                 EQ_x, 5101314b) /* SR_rt14 */                              \
     LBL(100501)
 
 /*
@@ -2074,6 +2141,64 @@
         jmpxx_lb(to)                                                        \
     LBL(51013##tg)
 
+/*
+ * Replicate subroutine calling behaviour for distance field evaluation
+ * by saving a given return address tag "tg" in the context's
+ * XMISC LST field, then jumping to the destination address "to".
+ * Local point is passed in Xmm1/2/3, signed distance is returned in Xmm0,
+ * Xmm7 is preserved, so the call can be nested within regular SUBROUTINE.
+ */
+#define DISTANCE(tg, to)                                                    \
+        movwx_mi(Mecx, ctx_XMISC(LST), IB(tg))                              \
+        jmpxx_lb(to)                                                        \
+    LBL(52013##tg)
+
+/*
+ * Distance field box.
+ * Compute signed distance from local point in Xmm1/2/3
+ * to the rounded box defined by surface's BOX fields, result in Xmm0.
+ */
+#define DIST_BOX() /* destroys Xmm0, Xmm1, Xmm2, Xmm3, Xmm4 */              \
+        andpx_ld(Xmm1, Mebp, inf_GPC04)                                     \
+        andpx_ld(Xmm2, Mebp, inf_GPC04)                                     \
+        andpx_ld(Xmm3, Mebp, inf_GPC04)                                     \
+        subps_ld(Xmm1, Mebx, sdf_BOX_X)                                     \
+        subps_ld(Xmm2, Mebx, sdf_BOX_Y)                                     \
+        subps_ld(Xmm3, Mebx, sdf_BOX_Z)                                     \
+        movpx_rr(Xmm4, Xmm1)                                                \
+        maxps_rr(Xmm4, Xmm2)                                                \
+        maxps_rr(Xmm4, Xmm3)                                                \
+        xorpx_rr(Xmm0, Xmm0)                                                \
+        minps_rr(Xmm4, Xmm0)                                                \
+        maxps_rr(Xmm1, Xmm0)                                                \
+        maxps_rr(Xmm2, Xmm0)                                                \
+        maxps_rr(Xmm3, Xmm0)                                                \
+        mulps_rr(Xmm1, Xmm1)                                                \
+        mulps_rr(Xmm2, Xmm2)                                                \
+        mulps_rr(Xmm3, Xmm3)                                                \
+        addps_rr(Xmm1, Xmm2)                                                \
+        addps_rr(Xmm1, Xmm3)                                                \
+        sqrps_rr(Xmm0, Xmm1)                                                \
+        addps_rr(Xmm0, Xmm4)                                                \
+        subps_ld(Xmm0, Mebx, sdf_BOX_R)
+
+/*
+ * Distance field Menger sponge's cross.
+ * Fold coordinate "XS" scaled to current level into its periodic cell,
+ * result "XD" is less than 1 outside of the cross's hole along that axis.
+ */
+#define DIST_CRS(XD, XS) /* destroys XD */                                  \
+        movpx_rr(W(XD), W(XS))                                              \
+        mulps_ld(W(XD), Mebp, inf_GPC02)                                    \
+        rnmps_rr(W(XD), W(XD))                                              \
+        addps_rr(W(XD), W(XD))                                              \
+        addps_rr(W(XD), W(XS))                                              \
+        addps_ld(W(XD), Mebp, inf_GPC01)                                    \
+        andpx_ld(W(XD), Mebp, inf_GPC04)                                    \
+        mulps_ld(W(XD), Mebp, inf_GPC03)                                    \
+        subps_ld(W(XD), Mebp, inf_GPC01)                                    \
+        andpx_ld(W(XD), Mebp, inf_GPC04)
+
 /******************************************************************************/
 /*********************************   RENDER   *********************************/
 /******************************************************************************/
@@ -2210,6 +2335,12 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
     LBL(880676) /* XX_cyc */
 
+#if RT_FEAT_COUNTERS
+
+        addxx_mi(Mebp, inf_CNT_PRI, IB(1))      /* count primary ray */
+
+#endif /* RT_FEAT_COUNTERS */
+
         movxx_ld(Redx, Mebp, inf_CAM)
 
         movpx_ld(Xmm0, Medx, cam_T_MAX)         /* tmp_v <- T_MAX */
@@ -2436,6 +2567,12 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
     LBL(990191) /* OO_ini */
 
+#if RT_FEAT_COUNTERS
+
+        addxx_mi(Mebp, inf_CNT_ELM, IB(1))      /* count list element */
+
+#endif /* RT_FEAT_COUNTERS */
+
         movxx_ld(Rebx, Mesi, elm_SIMD)
 
         /* use local (potentially adjusted)
@@ -2678,6 +2815,8 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
                  EQ_x, 880231f) /* QD_ptr */
         cmjwx_ri(Reax, IB(3),
                  EQ_x, 320231f) /* TP_ptr */
+        cmjwx_ri(Reax, IB(4),
+                 EQ_x, 720231f) /* SD_ptr */
 
 /******************************************************************************/
 /********************************   CLIPPING   ********************************/
@@ -2685,6 +2824,17 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
     LBL(660622) /* CC_clp */
 
+#if RT_FEAT_COUNTERS
+
+        addxx_mi(Mebp, inf_CNT_CLP, IB(1))      /* count clip test */
+
+        /* count active lanes, mask lanes are -1 */
+        movpx_ld(Xmm0, Mebp, inf_CNT_LNC)       /* lanes <- CNT_LNC */
+        subpx_rr(Xmm0, Xmm7)                    /* lanes -= tmask */
+        movpx_st(Xmm0, Mebp, inf_CNT_LNC)       /* lanes -> CNT_LNC */
+
+#endif /* RT_FEAT_COUNTERS */
+
         /* load "t_val" */
         movpx_ld(Xmm1, Mecx, ctx_T_VAL(0))      /* t_val <- T_VAL */
 
@@ -3223,6 +3373,8 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
                  EQ_x, 880622f) /* QD_clp */
         cmjwx_ri(Reax, IB(3),
                  EQ_x, 320622f) /* TP_clp */
+        cmjwx_ri(Reax, IB(4),
+                 EQ_x, 720622f) /* SD_clp */
 
     LBL(660153) /* CC_ret */
 
@@ -3247,6 +3399,8 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
                  EQ_x, 510133f) /* SR_rt3 */
         cmjwx_ri(Reax, IB(5),
                  EQ_x, 510135f) /* SR_rt5 */
+        cmjwx_ri(Reax, IB(12),
+                 EQ_x, 5101312f) /* SR_rt12 */
 
 /******************************************************************************/
 /********************************   MATERIAL   ********************************/
@@ -3744,6 +3898,15 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
 #endif /* RT_FEAT_BUFFERS */
 
+#if RT_FEAT_COUNTERS
+
+        movxx_ld(Reax, Mebp, inf_DEPTH)
+        subxx_ri(Reax, IB(1))
+        shlxx_ri(Reax, IB(1+P))
+        addxx_mi(Iebp, inf_CNT_SEC, IB(1))      /* count secondary ray */
+
+#endif /* RT_FEAT_COUNTERS */
+
         movpx_ld(Xmm0, Mecx, ctx_TMASK(0))      /* load tmask */
         movxx_ld(Reax, Mecx, ctx_LOCAL(FLG))
         orrxx_ri(Reax, IB(RT_FLAG_PASS_BACK))
@@ -4012,6 +4175,121 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
         movxx_ld(Redx, Medi, elm_SIMD)
 
+#if RT_FEAT_LIGHTS_AREA
+
+        cmjwx_mz(Medx, lgt_SHP_T,
+                 EQ_x, 230731f) /* LT_pnt */
+
+        /* hash hit position */
+        movpx_ld(Xmm1, Mecx, ctx_HIT_X(0))
+        mulps_ld(Xmm1, Medx, lgt_HSH_X)
+        movpx_ld(Xmm2, Mecx, ctx_HIT_Y(0))
+        mulps_ld(Xmm2, Medx, lgt_HSH_Y)
+        addps_rr(Xmm1, Xmm2)
+        movpx_ld(Xmm2, Mecx, ctx_HIT_Z(0))
+        mulps_ld(Xmm2, Medx, lgt_HSH_Z)
+        addps_rr(Xmm1, Xmm2)
+        rnmps_rr(Xmm2, Xmm1)
+        subps_rr(Xmm1, Xmm2)                    /* hash <- frac(hash) */
+
+        movpx_rr(Xmm2, Xmm1)
+        addps_ld(Xmm2, Medx, lgt_HSH_S)
+        mulps_rr(Xmm2, Xmm1)
+        mulps_ld(Xmm2, Medx, lgt_HSH_S)
+        rnmps_rr(Xmm1, Xmm2)
+        subps_rr(Xmm2, Xmm1)                    /* hash <- scrambled */
+
+        /* rotate per-element strata by hash */
+        movpx_ld(Xmm1, Medx, lgt_OFS_U)
+        addps_rr(Xmm1, Xmm2)
+        rnmps_rr(Xmm4, Xmm1)
+        subps_rr(Xmm1, Xmm4)                    /* smp_u in [0, 1) */
+
+        mulps_ld(Xmm2, Medx, lgt_HSH_S)
+        addps_ld(Xmm2, Medx, lgt_OFS_V)
+        rnmps_rr(Xmm4, Xmm2)
+        subps_rr(Xmm2, Xmm4)                    /* smp_v in [0, 1) */
+
+        addps_rr(Xmm1, Xmm1)
+        subps_ld(Xmm1, Mebp, inf_GPC01)         /* smp_u in [-1, 1) */
+        addps_rr(Xmm2, Xmm2)
+        subps_ld(Xmm2, Mebp, inf_GPC01)         /* smp_v in [-1, 1) */
+
+        xorpx_rr(Xmm3, Xmm3)
+        cmjwx_mi(Medx, lgt_SHP_T, IB(RT_LGT_RECT),
+                 EQ_x, 230732f) /* LT_rct */
+
+        /* map to sphere's surface, z = u, phi = v * PI */
+        movpx_rr(Xmm3, Xmm1)
+        movpx_rr(Xmm4, Xmm1)
+        mulps_rr(Xmm4, Xmm4)
+        movpx_ld(Xmm5, Mebp, inf_GPC01)
+        subps_rr(Xmm5, Xmm4)
+        sqrps_rr(Xmm5, Xmm5)                    /* Xmm5  <- sqrt(1 - z^2) */
+        mulps_ld(Xmm2, Medx, lgt_GPC01)
+
+        movpx_rr(Xmm6, Xmm2)
+        cosps_rr(Xmm1, Xmm6, Xmm7)
+        mulps_rr(Xmm1, Xmm5)
+        movpx_rr(Xmm6, Xmm2)
+        sinps_rr(Xmm2, Xmm6, Xmm7)
+        mulps_rr(Xmm2, Xmm5)
+
+    LBL(230732) /* LT_rct */
+
+        /* compute sample position */
+        movpx_ld(Xmm4, Medx, lgt_U_X)
+        mulps_rr(Xmm4, Xmm1)
+        movpx_ld(Xmm0, Medx, lgt_V_X)
+        mulps_rr(Xmm0, Xmm2)
+        addps_rr(Xmm4, Xmm0)
+        movpx_ld(Xmm0, Medx, lgt_W_X)
+        mulps_rr(Xmm0, Xmm3)
+        addps_rr(Xmm4, Xmm0)
+
+        movpx_ld(Xmm5, Medx, lgt_U_Y)
+        mulps_rr(Xmm5, Xmm1)
+        movpx_ld(Xmm0, Medx, lgt_V_Y)
+        mulps_rr(Xmm0, Xmm2)
+        addps_rr(Xmm5, Xmm0)
+        movpx_ld(Xmm0, Medx, lgt_W_Y)
+        mulps_rr(Xmm0, Xmm3)
+        addps_rr(Xmm5, Xmm0)
+
+        movpx_ld(Xmm6, Medx, lgt_U_Z)
+        mulps_rr(Xmm6, Xmm1)
+        movpx_ld(Xmm0, Medx, lgt_V_Z)
+        mulps_rr(Xmm0, Xmm2)
+        addps_rr(Xmm6, Xmm0)
+        movpx_ld(Xmm0, Medx, lgt_W_Z)
+        mulps_rr(Xmm0, Xmm3)
+        addps_rr(Xmm6, Xmm0)
+
+        /* compute common */
+        movpx_rr(Xmm1, Xmm4)
+        addps_ld(Xmm1, Medx, lgt_POS_X)         /* hit_x += POS_X */
+        subps_ld(Xmm1, Mecx, ctx_HIT_X(0))      /* hit_x -= HIT_X */
+        movpx_st(Xmm1, Mecx, ctx_NEW_X(0))      /* hit_x -> NEW_X */
+        mulps_ld(Xmm1, Mecx, ctx_NRM_X)         /* hit_x *= NRM_X */
+
+        movpx_rr(Xmm2, Xmm5)
+        addps_ld(Xmm2, Medx, lgt_POS_Y)         /* hit_y += POS_Y */
+        subps_ld(Xmm2, Mecx, ctx_HIT_Y(0))      /* hit_y -= HIT_Y */
+        movpx_st(Xmm2, Mecx, ctx_NEW_Y(0))      /* hit_y -> NEW_Y */
+        mulps_ld(Xmm2, Mecx, ctx_NRM_Y)         /* hit_y *= NRM_Y */
+
+        movpx_rr(Xmm3, Xmm6)
+        addps_ld(Xmm3, Medx, lgt_POS_Z)         /* hit_z += POS_Z */
+        subps_ld(Xmm3, Mecx, ctx_HIT_Z(0))      /* hit_z -= HIT_Z */
+        movpx_st(Xmm3, Mecx, ctx_NEW_Z(0))      /* hit_z -> NEW_Z */
+        mulps_ld(Xmm3, Mecx, ctx_NRM_Z)         /* hit_z *= NRM_Z */
+
+        jmpxx_lb(230733f) /* LT_dot */
+
+    LBL(230731) /* LT_pnt */
+
+#endif /* RT_FEAT_LIGHTS_AREA */
+
         /* compute common */
         movpx_ld(Xmm1, Medx, lgt_POS_X)         /* hit_x <- POS_X */
         subps_ld(Xmm1, Mecx, ctx_HIT_X(0))      /* hit_x -= HIT_X */
@@ -4028,6 +4306,12 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
         movpx_st(Xmm3, Mecx, ctx_NEW_Z(0))      /* hit_z -> NEW_Z */
         mulps_ld(Xmm3, Mecx, ctx_NRM_Z)         /* hit_z *= NRM_Z */
 
+#if RT_FEAT_LIGHTS_AREA
+
+    LBL(230733) /* LT_dot */
+
+#endif /* RT_FEAT_LIGHTS_AREA */
+
         movpx_rr(Xmm0, Xmm1)
         addps_rr(Xmm0, Xmm2)
         addps_rr(Xmm0, Xmm3)
@@ -4046,6 +4330,12 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
 /************************************ ENTER ***********************************/
 
+#if RT_FEAT_COUNTERS
+
+        addxx_mi(Mebp, inf_CNT_SHD, IB(1))      /* count shadow ray */
+
+#endif /* RT_FEAT_COUNTERS */
+
         movpx_ld(Xmm0, Mecx, ctx_TMASK(0))      /* load tmask */
         movxx_ld(Reax, Mecx, ctx_LOCAL(FLG))
         orrxx_ri(Reax, IB(RT_FLAG_PASS_BACK | RT_FLAG_SHAD))
@@ -4072,6 +4362,28 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
         movpx_st(Xmm0, Mecx, ctx_LOCAL(-C/2 + RT_SIMD_QUADS*8))
 
         movxx_ld(Resi, Medi, elm_DATA)          /* load shadow list */
+
+#if RT_FEAT_LIGHTS_SHADOWS_OCC
+
+        /* thread's own occluder cache holds light's last occluder,
+         * tagged with shadow list and tile it was found for,
+         * if both tags match test it first, then the whole list
+         * (cache's NEXT field points to the list's head) */
+        cmjxx_rz(Resi,
+                 EQ_x, 990676b) /* OO_cyc */
+        cmjxx_mz(Mebp, inf_OCC,
+                 EQ_x, 990676b) /* OO_cyc */
+        movxx_ld(Redi, Medx, lgt_OCC_O)
+        addxx_ld(Redi, Mebp, inf_OCC)
+        cmjxx_rm(Resi, Medi, elm_NEXT,
+                 NE_x, 990676b) /* OO_cyc */
+        TILE_OCCL(Reax)
+        cmjxx_rm(Reax, Medi, elm_TEMP,
+                 NE_x, 990676b) /* OO_cyc */
+        movxx_rr(Resi, Redi)
+
+#endif /* RT_FEAT_LIGHTS_SHADOWS_OCC */
+
         jmpxx_lb(990676b) /* OO_cyc */
 
     LBL(230153) /* LT_ret */
@@ -4095,6 +4407,41 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
 #endif /* RT_FEAT_LIGHTS_SHADOWS */
 
+#if RT_FEAT_LIGHTS_AREA
+
+        movxx_ld(Redx, Medi, elm_SIMD)
+
+        cmjwx_mz(Medx, lgt_SHP_T,
+                 EQ_x, 230734f) /* LT_shd */
+
+        /* area lights are sampled for shadows only,
+         * shading is computed from light's center */
+        movpx_ld(Xmm1, Medx, lgt_POS_X)         /* hit_x <- POS_X */
+        subps_ld(Xmm1, Mecx, ctx_HIT_X(0))      /* hit_x -= HIT_X */
+        movpx_st(Xmm1, Mecx, ctx_NEW_X(0))      /* hit_x -> NEW_X */
+        mulps_ld(Xmm1, Mecx, ctx_NRM_X)         /* hit_x *= NRM_X */
+
+        movpx_ld(Xmm2, Medx, lgt_POS_Y)         /* hit_y <- POS_Y */
+        subps_ld(Xmm2, Mecx, ctx_HIT_Y(0))      /* hit_y -= HIT_Y */
+        movpx_st(Xmm2, Mecx, ctx_NEW_Y(0))      /* hit_y -> NEW_Y */
+        mulps_ld(Xmm2, Mecx, ctx_NRM_Y)         /* hit_y *= NRM_Y */
+
+        movpx_ld(Xmm3, Medx, lgt_POS_Z)         /* hit_z <- POS_Z */
+        subps_ld(Xmm3, Mecx, ctx_HIT_Z(0))      /* hit_z -= HIT_Z */
+        movpx_st(Xmm3, Mecx, ctx_NEW_Z(0))      /* hit_z -> NEW_Z */
+        mulps_ld(Xmm3, Mecx, ctx_NRM_Z)         /* hit_z *= NRM_Z */
+
+        movpx_rr(Xmm0, Xmm1)
+        addps_rr(Xmm0, Xmm2)
+        addps_rr(Xmm0, Xmm3)
+
+        xorpx_rr(Xmm4, Xmm4)                    /* tmp_v <-     0 */
+        maxps_rr(Xmm0, Xmm4)                    /* r_dot max=     0 */
+
+    LBL(230734) /* LT_shd */
+
+#endif /* RT_FEAT_LIGHTS_AREA */
+
         /* compute common */
         movpx_ld(Xmm1, Mecx, ctx_NEW_X(0))
         movpx_rr(Xmm4, Xmm1)
@@ -4817,6 +5164,15 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
 #endif /* RT_FEAT_BUFFERS */
 
+#if RT_FEAT_COUNTERS
+
+        movxx_ld(Reax, Mebp, inf_DEPTH)
+        subxx_ri(Reax, IB(1))
+        shlxx_ri(Reax, IB(1+P))
+        addxx_mi(Iebp, inf_CNT_SEC, IB(1))      /* count secondary ray */
+
+#endif /* RT_FEAT_COUNTERS */
+
         movpx_ld(Xmm0, Mecx, ctx_TMASK(0))      /* load tmask */
         movxx_ld(Reax, Mecx, ctx_LOCAL(FLG))
         orrxx_ri(Reax, IB(RT_FLAG_PASS_THRU))
@@ -5232,6 +5588,15 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
 #endif /* RT_FEAT_BUFFERS */
 
+#if RT_FEAT_COUNTERS
+
+        movxx_ld(Reax, Mebp, inf_DEPTH)
+        subxx_ri(Reax, IB(1))
+        shlxx_ri(Reax, IB(1+P))
+        addxx_mi(Iebp, inf_CNT_SEC, IB(1))      /* count secondary ray */
+
+#endif /* RT_FEAT_COUNTERS */
+
         movpx_ld(Xmm0, Mecx, ctx_TMASK(0))      /* load tmask */
         movxx_ld(Reax, Mecx, ctx_LOCAL(FLG))
         orrxx_ri(Reax, IB(RT_FLAG_PASS_BACK))
@@ -5400,6 +5765,8 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
     LBL(510134) /* SR_rt4 *//* dummy target for CHECK_SHAD in PL */
     LBL(510136) /* SR_rt6 *//* dummy target for CHECK_SHAD in PL */
+    LBL(5101313) /* SR_rt13 *//* dummy target for CHECK_SHAD in PL, QD */
+    LBL(5101314) /* SR_rt14 *//* dummy target for CHECK_SHAD in PL, QD */
 
         cmjwx_ri(Reax, IB(1),
                  EQ_x, 510131f) /* SR_rt1 */
@@ -5409,6 +5776,10 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
                  EQ_x, 510134f) /* SR_rt4 */
         cmjwx_ri(Reax, IB(6),
                  EQ_x, 510136f) /* SR_rt6 */
+        cmjwx_ri(Reax, IB(13),
+                 EQ_x, 5101313f) /* SR_rt13 */
+        cmjwx_ri(Reax, IB(14),
+                 EQ_x, 5101314f) /* SR_rt14 */
 
 /******************************************************************************/
 /**********************************   ARRAY   *********************************/
@@ -5784,6 +6155,17 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
     LBL(880135) /* QD_rts */
 
+#if RT_FEAT_COUNTERS
+
+        addxx_mi(Mebp, inf_CNT_RTS, IB(1))      /* count root-solve */
+
+        /* count active lanes, mask lanes are -1 */
+        movpx_ld(Xmm7, Mebp, inf_CNT_LNR)       /* lanes <- CNT_LNR */
+        subpx_ld(Xmm7, Mecx, ctx_WMASK)         /* lanes -= WMASK */
+        movpx_st(Xmm7, Mebp, inf_CNT_LNR)       /* lanes -> CNT_LNR */
+
+#endif /* RT_FEAT_COUNTERS */
+
         /* create xmask */
         xorpx_rr(Xmm7, Xmm7)                    /* d_min <-     0 */
         cleps_rr(Xmm7, Xmm3)                    /* d_min <= d_val */
@@ -6496,6 +6878,505 @@ rt_void render0(rt_SIMD_INFOX *s_inf)
 
 #endif /* RT_FEAT_CLIPPING_CUSTOM */
 
+/******************************************************************************/
+/*****************************   DISTANCE FIELD   *****************************/
+/******************************************************************************/
+
+    LBL(720231) /* SD_ptr */
+
+#if RT_SHOW_TILES
+
+        SHOW_TILES(SD, 0x00444488)
+
+#endif /* RT_SHOW_TILES */
+
+        movwx_ld(Reax, Mebx, srf_A_SGN(RT_L*4)) /* Reax is used in Iecx */
+
+        /* "r" section */
+        movpx_ld(Xmm1, Iecx, ctx_RAY_X(0))      /* ray_x <- RAY_X */
+        movpx_ld(Xmm2, Iecx, ctx_RAY_Y(0))      /* ray_y <- RAY_Y */
+        movpx_ld(Xmm3, Iecx, ctx_RAY_Z(0))      /* ray_z <- RAY_Z */
+        mulps_rr(Xmm1, Xmm1)                    /* ray_x *= ray_x */
+        mulps_rr(Xmm2, Xmm2)                    /* ray_y *= ray_y */
+        mulps_rr(Xmm3, Xmm3)                    /* ray_z *= ray_z */
+        addps_rr(Xmm1, Xmm2)                    /* ry2_x += ry2_y */
+        addps_rr(Xmm1, Xmm3)                    /* ry2_t += ry2_z */
+        rsqps_rr(Xmm6, Xmm1) /* destroys Xmm1 *//* inv_r rs ray_r */
+        movpx_st(Xmm6, Mecx, ctx_XTMP2)         /* inv_r -> XTMP2 */
+
+        /* "l" section */
+        movpx_ld(Xmm1, Iecx, ctx_DFF_X)         /* dff_x <- DFF_X */
+        movpx_ld(Xmm2, Iecx, ctx_DFF_Y)         /* dff_y <- DFF_Y */
+        movpx_ld(Xmm3, Iecx, ctx_DFF_Z)         /* dff_z <- DFF_Z */
+        mulps_rr(Xmm1, Xmm1)                    /* dff_x *= dff_x */
+        mulps_rr(Xmm2, Xmm2)                    /* dff_y *= dff_y */
+        mulps_rr(Xmm3, Xmm3)                    /* dff_z *= dff_z */
+        addps_rr(Xmm1, Xmm2)                    /* df2_x += df2_y */
+        addps_rr(Xmm1, Xmm3)                    /* df2_t += df2_z */
+        sqrps_rr(Xmm0, Xmm1)                    /* t_lim sq df2_t */
+        addps_ld(Xmm0, Mebx, sdf_B_RAD)         /* t_lim += B_RAD */
+        mulps_rr(Xmm0, Xmm6)                    /* t_lim *= inv_r */
+        minps_ld(Xmm0, Mecx, ctx_T_BUF(0))      /* t_lim mn T_BUF */
+        /* use context's DMASK field
+         * as temporary storage for march limit */
+        movpx_st(Xmm0, Mecx, ctx_DMASK)         /* t_lim -> DMASK */
+
+        /* distance field offsets secondary rays originating from itself
+         * to avoid stopping the march right at the starting point */
+        xorpx_rr(Xmm0, Xmm0)                    /* t_val <-     0 */
+        cmjxx_rm(Rebx, Mecx, ctx_PARAM(OBJ),
+                 NE_x, 720691f) /* SD_go1 */
+        movpx_ld(Xmm0, Mebx, sdf_T_OFF)         /* t_val <- T_OFF */
+        mulps_rr(Xmm0, Xmm6)                    /* t_val *= inv_r */
+
+    LBL(720691) /* SD_go1 */
+
+        movpx_st(Xmm0, Mecx, ctx_XTMP1)         /* t_val -> XTMP1 */
+
+        /* init masks */
+        movpx_ld(Xmm7, Mecx, ctx_WMASK)         /* amask <- WMASK */
+        movpx_st(Xmm7, Mecx, ctx_TMASK(0))      /* amask -> TMASK */
+        xorpx_rr(Xmm0, Xmm0)                    /* xmask <-     0 */
+        movpx_st(Xmm0, Mecx, ctx_XMASK)         /* xmask -> XMASK */
+
+        movwx_ld(Redx, Mebx, sdf_SDF_T(FLG))    /* Redx is used as counter */
+
+    LBL(720676) /* SD_cyc */
+
+        /* march point */
+        movwx_ld(Reax, Mebx, srf_A_SGN(RT_L*4)) /* Reax is used in Iecx */
+        movpx_ld(Xmm0, Mecx, ctx_XTMP1)         /* t_val <- XTMP1 */
+        movpx_ld(Xmm1, Iecx, ctx_RAY_X(0))      /* loc_x <- RAY_X */
+        movpx_ld(Xmm2, Iecx, ctx_RAY_Y(0))      /* loc_y <- RAY_Y */
+        movpx_ld(Xmm3, Iecx, ctx_RAY_Z(0))      /* loc_z <- RAY_Z */
+        mulps_rr(Xmm1, Xmm0)                    /* loc_x *= t_val */
+        mulps_rr(Xmm2, Xmm0)                    /* loc_y *= t_val */
+        mulps_rr(Xmm3, Xmm0)                    /* loc_z *= t_val */
+        addps_ld(Xmm1, Iecx, ctx_DFF_X)         /* loc_x += DFF_X */
+        addps_ld(Xmm2, Iecx, ctx_DFF_Y)         /* loc_y += DFF_Y */
+        addps_ld(Xmm3, Iecx, ctx_DFF_Z)         /* loc_z += DFF_Z */
+
+        DISTANCE(1, 720314f) /* SD_dst */
+
+        /* starting side */
+        cmjwx_rm(Redx, Mebx, sdf_SDF_T(FLG),
+                 NE_x, 720684f) /* SD_chk */
+        xorpx_rr(Xmm1, Xmm1)                    /* amask <-     0 */
+        cgtps_rr(Xmm1, Xmm0)                    /* amask >! d_val */
+        /* use context's AMASK field
+         * as storage for starting side */
+        movpx_st(Xmm1, Mecx, ctx_AMASK)         /* amask -> AMASK */
+
+    LBL(720684) /* SD_chk */
+
+        /* hit check */
+        andpx_ld(Xmm0, Mebp, inf_GPC04)         /* d_val = |d_val| */
+        movpx_ld(Xmm7, Mecx, ctx_TMASK(0))      /* tmask <- TMASK */
+        movpx_ld(Xmm1, Mebx, sdf_H_EPS)         /* hmask <- H_EPS */
+        cgtps_rr(Xmm1, Xmm0)                    /* hmask >! d_val */
+        andpx_rr(Xmm1, Xmm7)                    /* hmask &= tmask */
+        xorpx_rr(Xmm7, Xmm1)                    /* tmask ^= hmask */
+        orrpx_ld(Xmm1, Mecx, ctx_XMASK)         /* hmask |= XMASK */
+        movpx_st(Xmm1, Mecx, ctx_XMASK)         /* hmask -> XMASK */
+
+        /* march step */
+        mulps_ld(Xmm0, Mecx, ctx_XTMP2)         /* d_val *= inv_r */
+        andpx_rr(Xmm0, Xmm7)                    /* d_val &= tmask */
+        addps_ld(Xmm0, Mecx, ctx_XTMP1)         /* t_val += XTMP1 */
+        movpx_st(Xmm0, Mecx, ctx_XTMP1)         /* t_val -> XTMP1 */
+        cltps_ld(Xmm0, Mecx, ctx_DMASK)         /* t_val <! t_lim */
+        andpx_rr(Xmm7, Xmm0)                    /* tmask &= lmask */
+        movpx_st(Xmm7, Mecx, ctx_TMASK(0))      /* tmask -> TMASK */
+        CHECK_MASK(720923f, NONE, Xmm7)         /* SD_out */
+
+        subwx_ri(Redx, IB(1))
+        cmjwx_rz(Redx,
+                 NE_x, 720676b) /* SD_cyc */
+
+    LBL(720923) /* SD_out */
+
+        movpx_ld(Xmm0, Mecx, ctx_XTMP1)         /* t_val <- XTMP1 */
+        movpx_st(Xmm0, Mecx, ctx_T_VAL(0))      /* t_val -> T_VAL */
+        movpx_ld(Xmm7, Mecx, ctx_XMASK)         /* xmask <- XMASK */
+        CHECK_MASK(990598f, NONE, Xmm7)         /* OO_end */
+
+        /* use context's TEX_U field
+         * as temporary storage for remaining steps */
+        movwx_st(Redx, Mecx, ctx_TEX_U)
+
+        /* clipping */
+        SUBROUTINE(12, 660622b) /* CC_clp */
+        movpx_ld(Xmm0, Mecx, ctx_XMASK)         /* cmask <- XMASK */
+        xorpx_rr(Xmm0, Xmm7)                    /* cmask ^= xmask */
+        movpx_st(Xmm7, Mecx, ctx_XMASK)         /* xmask -> XMASK */
+        CHECK_MASK(720926f, NONE, Xmm0)         /* SD_hit */
+
+        /* resume the march past clipped hits,
+         * the other side of the surface is next */
+        movpx_ld(Xmm1, Mebx, sdf_T_OFF)         /* t_off <- T_OFF */
+        mulps_ld(Xmm1, Mecx, ctx_XTMP2)         /* t_off *= inv_r */
+        andpx_rr(Xmm1, Xmm0)                    /* t_off &= cmask */
+        addps_ld(Xmm1, Mecx, ctx_XTMP1)         /* t_val += XTMP1 */
+        movpx_st(Xmm1, Mecx, ctx_XTMP1)         /* t_val -> XTMP1 */
+        cltps_ld(Xmm1, Mecx, ctx_DMASK)         /* t_val <! t_lim */
+        andpx_rr(Xmm0, Xmm1)                    /* cmask &= lmask */
+        CHECK_MASK(720926f, NONE, Xmm0)         /* SD_hit */
+        movpx_st(Xmm0, Mecx, ctx_TMASK(0))      /* cmask -> TMASK */
+        xorpx_ld(Xmm0, Mecx, ctx_AMASK)         /* cmask ^= AMASK */
+        movpx_st(Xmm0, Mecx, ctx_AMASK)         /* amask -> AMASK */
+
+        movwx_ld(Redx, Mecx, ctx_TEX_U)
+        cmjwx_rz(Redx,
+                 EQ_x, 720926f) /* SD_hit */
+        subwx_ri(Redx, IB(1))
+        jmpxx_lb(720676b) /* SD_cyc */
+
+    LBL(720926) /* SD_hit */
+
+        movpx_ld(Xmm7, Mecx, ctx_XMASK)         /* xmask <- XMASK */
+        CHECK_MASK(990598f, NONE, Xmm7)         /* OO_end */
+
+/******************************************************************************/
+/*  LBL(SD_rt1)  */
+
+        /* outer side */
+        movpx_ld(Xmm0, Mecx, ctx_AMASK)         /* amask <- AMASK */
+        annpx_rr(Xmm0, Xmm7)                    /* amask #= xmask */
+        movpx_st(Xmm0, Mecx, ctx_TMASK(0))      /* tmask -> TMASK */
+        CHECK_MASK(720132f, NONE, Xmm0)         /* SD_rt2 */
+        movxx_mi(Mecx, ctx_LOCAL(FLG), IB(RT_FLAG_SIDE_OUTER))
+
+#if RT_FEAT_BUFFERS
+
+        CHECK_FLAG(720841f, PARAM, RT_FLAG_SHAD) /* SD_bf1 */
+
+        jmpxx_lb(720331f) /* SD_mt1 */
+
+    LBL(720841) /* SD_bf1 */
+
+        movxx_ri(Redx, IB(RT_FLAG_SIDE_OUTER))
+        STORE_SPTR(SD_rt1) /* destroys Xmm0/1/2, Reax; reads Rebx, Redx, Resi */
+
+        jmpxx_lb(720132f)
+
+    LBL(720331) /* SD_mt1 */
+
+#endif /* RT_FEAT_BUFFERS */
+
+        /* material */
+        SUBROUTINE(13, 720353f) /* SD_mat */
+
+/******************************************************************************/
+    LBL(720132) /* SD_rt2 */
+
+        /* inner side */
+        movpx_ld(Xmm7, Mecx, ctx_TMASK(0))      /* tmask <- TMASK */
+        xorpx_ld(Xmm7, Mecx, ctx_XMASK)         /* tmask ^= XMASK */
+        CHECK_MASK(990598f, NONE, Xmm7)         /* OO_end */
+        movpx_st(Xmm7, Mecx, ctx_TMASK(0))      /* tmask -> TMASK */
+        movxx_mi(Mecx, ctx_LOCAL(FLG), IB(RT_FLAG_SIDE_INNER))
+
+#if RT_FEAT_BUFFERS
+
+        CHECK_FLAG(720842f, PARAM, RT_FLAG_SHAD) /* SD_bf2 */
+
+        jmpxx_lb(720332f) /* SD_mt2 */
+
+    LBL(720842) /* SD_bf2 */
+
+        movxx_ri(Redx, IB(RT_FLAG_SIDE_INNER))
+        STORE_SPTR(SD_rt2) /* destroys Xmm0/1/2, Reax; reads Rebx, Redx, Resi */
+
+        jmpxx_lb(990598f) /* OO_end */
+
+    LBL(720332) /* SD_mt2 */
+
+#endif /* RT_FEAT_BUFFERS */
+
+        /* material */
+        SUBROUTINE(14, 720353f) /* SD_mat */
+
+        jmpxx_lb(990598f) /* OO_end */
+
+/******************************************************************************/
+    LBL(720353) /* SD_mat */
+
+        FETCH_PROP()                            /* Xmm7  <- tside */
+
+#if RT_FEAT_LIGHTS_SHADOWS
+
+        CHECK_SHAD(SD_shd)
+
+#endif /* RT_FEAT_LIGHTS_SHADOWS */
+
+#if RT_FEAT_NORMALS
+
+        /* compute normal, if enabled */
+        CHECK_PROP(720913f, RT_PROP_NORMAL)     /* SD_nrm */
+
+        /* tetrahedral gradient, "k0" section */
+        movwx_ld(Reax, Mebx, srf_A_SGN(RT_L*4)) /* Reax is used in Iecx */
+        /* use next context's RAY fields (NEW)
+         * as temporary storage for local HIT */
+        movpx_ld(Xmm1, Iecx, ctx_NEW_X(0))      /* loc_x <- NEW_X */
+        movpx_ld(Xmm2, Iecx, ctx_NEW_Y(0))      /* loc_y <- NEW_Y */
+        movpx_ld(Xmm3, Iecx, ctx_NEW_Z(0))      /* loc_z <- NEW_Z */
+        addps_ld(Xmm1, Mebx, sdf_N_EPS)         /* loc_x += N_EPS */
+        subps_ld(Xmm2, Mebx, sdf_N_EPS)         /* loc_y -= N_EPS */
+        subps_ld(Xmm3, Mebx, sdf_N_EPS)         /* loc_z -= N_EPS */
+
+        DISTANCE(2, 720314f) /* SD_dst */
+
+        movwx_ld(Reax, Mebx, srf_A_SGN(RT_L*4)) /* Reax is used in Iecx */
+        movpx_rr(Xmm4, Xmm0)                    /* nrm_x <- d_val */
+        xorpx_ld(Xmm0, Mebp, inf_GPC06)         /* d_val = -d_val */
+        movpx_st(Xmm4, Iecx, ctx_NRM_X)         /* nrm_x -> NRM_X */
+        movpx_st(Xmm0, Iecx, ctx_NRM_Y)         /* nrm_y -> NRM_Y */
+        movpx_st(Xmm0, Iecx, ctx_NRM_Z)         /* nrm_z -> NRM_Z */
+
+        /* "k1" section */
+        movpx_ld(Xmm1, Iecx, ctx_NEW_X(0))      /* loc_x <- NEW_X */
+        movpx_ld(Xmm2, Iecx, ctx_NEW_Y(0))      /* loc_y <- NEW_Y */
+        movpx_ld(Xmm3, Iecx, ctx_NEW_Z(0))      /* loc_z <- NEW_Z */
+        subps_ld(Xmm1, Mebx, sdf_N_EPS)         /* loc_x -= N_EPS */
+        subps_ld(Xmm2, Mebx, sdf_N_EPS)         /* loc_y -= N_EPS */
+        addps_ld(Xmm3, Mebx, sdf_N_EPS)         /* loc_z += N_EPS */
+
+        DISTANCE(3, 720314f) /* SD_dst */
+
+        movwx_ld(Reax, Mebx, srf_A_SGN(RT_L*4)) /* Reax is used in Iecx */
+        movpx_ld(Xmm4, Iecx, ctx_NRM_X)         /* nrm_x <- NRM_X */
+        movpx_ld(Xmm5, Iecx, ctx_NRM_Y)         /* nrm_y <- NRM_Y */
+        movpx_ld(Xmm6, Iecx, ctx_NRM_Z)         /* nrm_z <- NRM_Z */
+        subps_rr(Xmm4, Xmm0)                    /* nrm_x -= d_val */
+        subps_rr(Xmm5, Xmm0)                    /* nrm_y -= d_val */
+        addps_rr(Xmm6, Xmm0)                    /* nrm_z += d_val */
+        movpx_st(Xmm4, Iecx, ctx_NRM_X)         /* nrm_x -> NRM_X */
+        movpx_st(Xmm5, Iecx, ctx_NRM_Y)         /* nrm_y -> NRM_Y */
+        movpx_st(Xmm6, Iecx, ctx_NRM_Z)         /* nrm_z -> NRM_Z */
+
+        /* "k2" section */
+        movpx_ld(Xmm1, Iecx, ctx_NEW_X(0))      /* loc_x <- NEW_X */
+        movpx_ld(Xmm2, Iecx, ctx_NEW_Y(0))      /* loc_y <- NEW_Y */
+        movpx_ld(Xmm3, Iecx, ctx_NEW_Z(0))      /* loc_z <- NEW_Z */
+        subps_ld(Xmm1, Mebx, sdf_N_EPS)         /* loc_x -= N_EPS */
+        addps_ld(Xmm2, Mebx, sdf_N_EPS)         /* loc_y += N_EPS */
+        subps_ld(Xmm3, Mebx, sdf_N_EPS)         /* loc_z -= N_EPS */
+
+        DISTANCE(4, 720314f) /* SD_dst */
+
+        movwx_ld(Reax, Mebx, srf_A_SGN(RT_L*4)) /* Reax is used in Iecx */
+        movpx_ld(Xmm4, Iecx, ctx_NRM_X)         /* nrm_x <- NRM_X */
+        movpx_ld(Xmm5, Iecx, ctx_NRM_Y)         /* nrm_y <- NRM_Y */
+        movpx_ld(Xmm6, Iecx, ctx_NRM_Z)         /* nrm_z <- NRM_Z */
+        subps_rr(Xmm4, Xmm0)                    /* nrm_x -= d_val */
+        addps_rr(Xmm5, Xmm0)                    /* nrm_y += d_val */
+        subps_rr(Xmm6, Xmm0)                    /* nrm_z -= d_val */
+        movpx_st(Xmm4, Iecx, ctx_NRM_X)         /* nrm_x -> NRM_X */
+        movpx_st(Xmm5, Iecx, ctx_NRM_Y)         /* nrm_y -> NRM_Y */
+        movpx_st(Xmm6, Iecx, ctx_NRM_Z)         /* nrm_z -> NRM_Z */
+
+        /* "k3" section */
+        movpx_ld(Xmm1, Iecx, ctx_NEW_X(0))      /* loc_x <- NEW_X */
+        movpx_ld(Xmm2, Iecx, ctx_NEW_Y(0))      /* loc_y <- NEW_Y */
+        movpx_ld(Xmm3, Iecx, ctx_NEW_Z(0))      /* loc_z <- NEW_Z */
+        addps_ld(Xmm1, Mebx, sdf_N_EPS)         /* loc_x += N_EPS */
+        addps_ld(Xmm2, Mebx, sdf_N_EPS)         /* loc_y += N_EPS */
+        addps_ld(Xmm3, Mebx, sdf_N_EPS)         /* loc_z += N_EPS */
+
+        DISTANCE(5, 720314f) /* SD_dst */
+
+        movwx_ld(Reax, Mebx, srf_A_SGN(RT_L*4)) /* Reax is used in Iecx */
+        movpx_ld(Xmm4, Iecx, ctx_NRM_X)         /* nrm_x <- NRM_X */
+        movpx_ld(Xmm5, Iecx, ctx_NRM_Y)         /* nrm_y <- NRM_Y */
+        movpx_ld(Xmm6, Iecx, ctx_NRM_Z)         /* nrm_z <- NRM_Z */
+        addps_rr(Xmm4, Xmm0)                    /* nrm_x += d_val */
+        addps_rr(Xmm5, Xmm0)                    /* nrm_y += d_val */
+        addps_rr(Xmm6, Xmm0)                    /* nrm_z += d_val */
+
+        /* normalize normal */
+        movpx_rr(Xmm1, Xmm4)                    /* nrm_x <- nrm_x */
+        movpx_rr(Xmm2, Xmm5)                    /* nrm_y <- nrm_y */
+        movpx_rr(Xmm3, Xmm6)                    /* nrm_z <- nrm_z */
+
+        mulps_rr(Xmm1, Xmm4)                    /* nrm_x *= nrm_x */
+        mulps_rr(Xmm2, Xmm5)                    /* nrm_y *= nrm_y */
+        mulps_rr(Xmm3, Xmm6)                    /* nrm_z *= nrm_z */
+
+        addps_rr(Xmm1, Xmm2)                    /* nr2_x += nr2_y */
+        addps_rr(Xmm1, Xmm3)                    /* nr2_t += nr2_z */
+        rsqps_rr(Xmm0, Xmm1) /* destroys Xmm1 *//* inv_r rs nrm_r */
+        xorpx_rr(Xmm0, Xmm7)                    /* inv_r ^= tside */
+
+        mulps_rr(Xmm4, Xmm0)                    /* nrm_x *= inv_r */
+        mulps_rr(Xmm5, Xmm0)                    /* nrm_y *= inv_r */
+        mulps_rr(Xmm6, Xmm0)                    /* nrm_z *= inv_r */
+
+        /* store normal */
+        movpx_st(Xmm4, Iecx, ctx_NRM_X)         /* nrm_x -> NRM_X */
+        movpx_st(Xmm5, Iecx, ctx_NRM_Y)         /* nrm_y -> NRM_Y */
+        movpx_st(Xmm6, Iecx, ctx_NRM_Z)         /* nrm_z -> NRM_Z */
+
+        jmpxx_lb(330913b) /* MT_nrm */
+
+    LBL(720913) /* SD_nrm */
+
+#endif /* RT_FEAT_NORMALS */
+
+        jmpxx_lb(330353b) /* MT_mat */
+
+/******************************************************************************/
+#if RT_FEAT_CLIPPING_CUSTOM
+
+    LBL(720622) /* SD_clp */
+
+        movwx_ld(Reax, Mebx, srf_A_SGN(RT_L*4)) /* Reax is used in Iecx */
+
+        /* use context's normal fields (NRM)
+         * as temporary storage for clipping */
+        movpx_ld(Xmm1, Iecx, ctx_NRM_X)         /* loc_x <- DFF_X */
+        movpx_ld(Xmm2, Iecx, ctx_NRM_Y)         /* loc_y <- DFF_Y */
+        movpx_ld(Xmm3, Iecx, ctx_NRM_Z)         /* loc_z <- DFF_Z */
+
+        DISTANCE(6, 720314f) /* SD_dst */
+
+        movpx_rr(Xmm4, Xmm0)                    /* d_val <- d_val */
+        xorpx_rr(Xmm0, Xmm0)                    /* tmp_v <-     0 */
+
+        APPLY_CLIP(SD, Xmm4, Xmm0)
+
+        jmpxx_lb(660153b) /* CC_ret */
+
+#endif /* RT_FEAT_CLIPPING_CUSTOM */
+
+/******************************************************************************/
+    LBL(720314) /* SD_dst */
+
+        movwx_ld(Reax, Mebx, sdf_SDF_T(PTR))    /* distance field kind */
+
+        cmjwx_ri(Reax, IB(1),
+                 EQ_x, 720641f) /* SD_box */
+        cmjwx_ri(Reax, IB(2),
+                 EQ_x, 720642f) /* SD_bld */
+        cmjwx_ri(Reax, IB(3),
+                 EQ_x, 720643f) /* SD_mng */
+
+        /* sphere */
+        mulps_rr(Xmm1, Xmm1)                    /* loc_x *= loc_x */
+        mulps_rr(Xmm2, Xmm2)                    /* loc_y *= loc_y */
+        mulps_rr(Xmm3, Xmm3)                    /* loc_z *= loc_z */
+        addps_rr(Xmm1, Xmm2)                    /* lc2_x += lc2_y */
+        addps_rr(Xmm1, Xmm3)                    /* lc2_t += lc2_z */
+        sqrps_rr(Xmm0, Xmm1)                    /* d_val sq lc2_t */
+        subps_ld(Xmm0, Mebx, sdf_SPH_R)         /* d_val -= SPH_R */
+
+        jmpxx_lb(720153f) /* SD_ret */
+
+    LBL(720641) /* SD_box */
+
+        DIST_BOX()                              /* d_val <- box_d */
+
+        jmpxx_lb(720153f) /* SD_ret */
+
+    LBL(720642) /* SD_bld */
+
+        /* blend of box and sphere, signs select
+         * between union, intersection and subtraction */
+        movpx_rr(Xmm4, Xmm1)                    /* lc2_x <- loc_x */
+        movpx_rr(Xmm5, Xmm2)                    /* lc2_y <- loc_y */
+        movpx_rr(Xmm6, Xmm3)                    /* lc2_z <- loc_z */
+        mulps_rr(Xmm4, Xmm4)                    /* lc2_x *= lc2_x */
+        mulps_rr(Xmm5, Xmm5)                    /* lc2_y *= lc2_y */
+        mulps_rr(Xmm6, Xmm6)                    /* lc2_z *= lc2_z */
+        addps_rr(Xmm4, Xmm5)                    /* lc2_x += lc2_y */
+        addps_rr(Xmm4, Xmm6)                    /* lc2_t += lc2_z */
+        sqrps_rr(Xmm5, Xmm4)                    /* sph_d sq lc2_t */
+        subps_ld(Xmm5, Mebx, sdf_SPH_R)         /* sph_d -= SPH_R */
+        xorpx_ld(Xmm5, Mebx, sdf_SGN_B)         /* sph_d ^= SGN_B */
+
+        DIST_BOX()                              /* box_d <- box_d */
+
+        xorpx_ld(Xmm0, Mebx, sdf_SGN_A)         /* box_d ^= SGN_A */
+
+        /* polynomial smooth minimum */
+        movpx_rr(Xmm1, Xmm0)                    /* dst_v <- box_d */
+        subps_rr(Xmm1, Xmm5)                    /* dst_v -= sph_d */
+        andpx_ld(Xmm1, Mebp, inf_GPC04)         /* dst_v = |dst_v| */
+        movpx_ld(Xmm2, Mebx, sdf_BLD_K)         /* h_val <- BLD_K */
+        subps_rr(Xmm2, Xmm1)                    /* h_val -= dst_v */
+        xorpx_rr(Xmm3, Xmm3)                    /* tmp_v <-     0 */
+        maxps_rr(Xmm2, Xmm3)                    /* h_val mx tmp_v */
+        mulps_rr(Xmm2, Xmm2)                    /* h_val *= h_val */
+        mulps_ld(Xmm2, Mebx, sdf_BLD_Q)         /* h_val *= BLD_Q */
+        minps_rr(Xmm0, Xmm5)                    /* d_val mn sph_d */
+        subps_rr(Xmm0, Xmm2)                    /* d_val -= h_val */
+        xorpx_ld(Xmm0, Mebx, sdf_SGN_A)         /* d_val ^= SGN_A */
+
+        jmpxx_lb(720153f) /* SD_ret */
+
+    LBL(720643) /* SD_mng */
+
+        /* menger sponge, box with crosses cut out at each level,
+         * keeps the distance bound as the step is scaled back by M_FIN */
+        mulps_ld(Xmm1, Mebx, sdf_M_INV)         /* loc_x *= M_INV */
+        mulps_ld(Xmm2, Mebx, sdf_M_INV)         /* loc_y *= M_INV */
+        mulps_ld(Xmm3, Mebx, sdf_M_INV)         /* loc_z *= M_INV */
+        movpx_rr(Xmm0, Xmm1)                    /* d_val <- loc_x */
+        andpx_ld(Xmm0, Mebp, inf_GPC04)         /* d_val = |d_val| */
+        movpx_rr(Xmm4, Xmm2)                    /* tmp_v <- loc_y */
+        andpx_ld(Xmm4, Mebp, inf_GPC04)         /* tmp_v = |tmp_v| */
+        maxps_rr(Xmm0, Xmm4)                    /* d_val mx tmp_v */
+        movpx_rr(Xmm4, Xmm3)                    /* tmp_v <- loc_z */
+        andpx_ld(Xmm4, Mebp, inf_GPC04)         /* tmp_v = |tmp_v| */
+        maxps_rr(Xmm0, Xmm4)                    /* d_val mx tmp_v */
+        subps_ld(Xmm0, Mebp, inf_GPC01)         /* d_val -= +1.0f */
+        movwx_ld(Reax, Mebx, sdf_SDF_T(LST))    /* Reax is used as counter */
+
+    LBL(720644) /* SD_mcy */
+
+        mulps_ld(Xmm0, Mebp, inf_GPC03)         /* d_val *= +3.0f */
+
+        /* cross is the median of per-axis distances */
+        DIST_CRS(Xmm4, Xmm1)                    /* crs_x <- loc_x */
+        DIST_CRS(Xmm5, Xmm2)                    /* crs_y <- loc_y */
+        movpx_rr(Xmm6, Xmm4)                    /* crs_l <- crs_x */
+        minps_rr(Xmm6, Xmm5)                    /* crs_l mn crs_y */
+        maxps_rr(Xmm4, Xmm5)                    /* crs_h mx crs_y */
+        DIST_CRS(Xmm5, Xmm3)                    /* crs_z <- loc_z */
+        minps_rr(Xmm4, Xmm5)                    /* crs_h mn crs_z */
+        maxps_rr(Xmm4, Xmm6)                    /* crs_h mx crs_l */
+        subps_ld(Xmm4, Mebp, inf_GPC01)         /* crs_h -= +1.0f */
+        maxps_rr(Xmm0, Xmm4)                    /* d_val mx crs_h */
+
+        mulps_ld(Xmm1, Mebp, inf_GPC03)         /* loc_x *= +3.0f */
+        mulps_ld(Xmm2, Mebp, inf_GPC03)         /* loc_y *= +3.0f */
+        mulps_ld(Xmm3, Mebp, inf_GPC03)         /* loc_z *= +3.0f */
+
+        subwx_ri(Reax, IB(1))
+        cmjwx_rz(Reax,
+                 NE_x, 720644b) /* SD_mcy */
+
+        mulps_ld(Xmm0, Mebx, sdf_M_FIN)         /* d_val *= M_FIN */
+
+    LBL(720153) /* SD_ret */
+
+        movwx_ld(Reax, Mecx, ctx_XMISC(LST))
+
+        cmjwx_ri(Reax, IB(1),
+                 EQ_x, 520131b) /* SD_rt1 */
+        cmjwx_ri(Reax, IB(2),
+                 EQ_x, 520132b) /* SD_rt2 */
+        cmjwx_ri(Reax, IB(3),
+                 EQ_x, 520133b) /* SD_rt3 */
+        cmjwx_ri(Reax, IB(4),
+                 EQ_x, 520134b) /* SD_rt4 */
+        cmjwx_ri(Reax, IB(5),
+                 EQ_x, 520135b) /* SD_rt5 */
+#if RT_FEAT_CLIPPING_CUSTOM
+        cmjwx_ri(Reax, IB(6),
+                 EQ_x, 520136b) /* SD_rt6 */
+#endif /* RT_FEAT_CLIPPING_CUSTOM */
+
 /******************************************************************************/
 /*********************************   QUARTIC   ********************************/
 /******************************************************************************/
@@ -8121,6 +9002,17 @@ rt_void rt_Platform::update0(rt_SIMD_SURFACE *s_srf)
         return;
     }
 
+    /* distance field has its own solver */
+    if (tag == RT_TAG_DISTFIELD)
+    {
+        s_srf->srf_t[0] = 4;
+        s_srf->srf_t[1] = 4;
+        s_srf->srf_t[2] = 4;
+
+        s_srf->msc_p[1] = (rt_pntr)0;
+        return;
+    }
+
     /* set surface's tags */
     s_srf->srf_t[0] = tag > RT_TAG_PLANE ?
                      (tag == RT_TAG_HYPERCYLINDER &&
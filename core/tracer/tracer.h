@@ -19,7 +19,7 @@
  * 16  means 1/16 DP-level  (8-bit displacements) has not been exceeded (Q=1).
  * NOTE: the built-in rt_SIMD_INFO structure is already filled at full 1/16th.
  */
-#if RT_DEBUG >= 1
+#if RT_DEBUG >= 1 || RT_FEAT_COUNTERS
 #define RT_DATA 2 /* for rt_SIMD_INFOX */
 #elif RT_OFFS_BUFFERS
 #define RT_DATA 2 /* for rt_SIMD_CONTEXT (with SIMD-buffers) */
@@ -50,6 +50,29 @@
 
 #define RT_STACK_DEPTH          10 /* context stack depth for secondary rays */
 
+/*
+ * Optional per-thread hot-path counters in the rendering backend,
+ * no code is emitted for them when disabled (default).
+ * Counters are reset by the engine before each frame's render0.
+ */
+#ifndef RT_FEAT_COUNTERS
+#define RT_FEAT_COUNTERS        0 /* enable with -DRT_FEAT_COUNTERS=1 */
+#endif /* RT_FEAT_COUNTERS */
+
+/*
+ * Hot-path counter indices (in the order of rt_SIMD_INFOX fields),
+ * secondary rays occupy RT_STACK_DEPTH counters indexed by remaining depth.
+ */
+#define RT_CNT_PRIMARY          0 /* primary ray packets */
+#define RT_CNT_SHADOW           1 /* shadow ray packets */
+#define RT_CNT_ROOTS            2 /* quadric root-solves (QD_rts) */
+#define RT_CNT_ROOTS_LANES      3 /* active SIMD lanes entering root-solves */
+#define RT_CNT_CLIP             4 /* clip tests (CC_clp) */
+#define RT_CNT_CLIP_LANES       5 /* active SIMD lanes entering clip tests */
+#define RT_CNT_ELEMS            6 /* object list elements walked (OO_ini) */
+#define RT_CNT_SECONDARY        7 /* secondary ray packets per depth level */
+#define RT_CNT_TOTAL            (7 + RT_STACK_DEPTH)
+
 #define LCG16                   16
 #define LCG24                   24
 #define LCG32                   32 /* applicable to 64-bit SIMD elements only */
@@ -104,6 +127,7 @@ struct rt_SIMD_CONTEXT;
 struct rt_SIMD_CAMERA;
 struct rt_SIMD_LIGHT;
 struct rt_SIMD_SURFACE;
+struct rt_SIMD_DISTFIELD;
 
 struct rt_SIMD_MATERIAL;
 
@@ -246,8 +270,41 @@ struct rt_SIMD_INFOX : public rt_SIMD_INFO
     rt_word srf_s;
 #define inf_SRF_S           DP(Q*0x100+0x06C*P+E)
 
-    rt_word pad11[36];
-#define inf_PAD11           DP(Q*0x100+0x070*P+E)
+    /* hot-path counters (RT_FEAT_COUNTERS) */
+
+    rt_word cnt_pri;
+#define inf_CNT_PRI         DP(Q*0x100+0x070*P+E)
+
+    rt_word cnt_shd;
+#define inf_CNT_SHD         DP(Q*0x100+0x074*P+E)
+
+    rt_word cnt_rts;
+#define inf_CNT_RTS         DP(Q*0x100+0x078*P+E)
+
+    rt_word cnt_rtl;
+#define inf_CNT_RTL         DP(Q*0x100+0x07C*P+E)
+
+    rt_word cnt_clp;
+#define inf_CNT_CLP         DP(Q*0x100+0x080*P+E)
+
+    rt_word cnt_cll;
+#define inf_CNT_CLL         DP(Q*0x100+0x084*P+E)
+
+    rt_word cnt_elm;
+#define inf_CNT_ELM         DP(Q*0x100+0x088*P+E)
+
+    rt_word cnt_sec[RT_STACK_DEPTH];
+#define inf_CNT_SEC         DP(Q*0x100+0x08C*P+E)
+
+    /* thread's own occluder cache (NULL if off), element per light:
+     * simd - last occluder, temp - its tile, next - its shadow list,
+     * written in backend, not shared with other threads */
+
+    rt_pntr occ;
+#define inf_OCC             DP(Q*0x100+0x0B4*P+E)
+
+    rt_word pad11[28-RT_STACK_DEPTH];
+#define inf_PAD11           DP(Q*0x100+0x0B8*P+E)
 
     rt_uelm prngf[S];
 #define inf_PRNGF           DP(Q*0x100+0x100*P)
@@ -297,151 +354,160 @@ struct rt_SIMD_INFOX : public rt_SIMD_INFO
     rt_real cos_8[S];
 #define inf_COS_8           DP(Q*0x1F0+0x100*P)
 
+    /* active SIMD lanes per counter (RT_FEAT_COUNTERS),
+     * folded into cnt_rtl and cnt_cll by the engine */
+
+    rt_uelm cnt_lnr[S];
+#define inf_CNT_LNR         DP(Q*0x200+0x100*P)
+
+    rt_uelm cnt_lnc[S];
+#define inf_CNT_LNC         DP(Q*0x210+0x100*P)
+
 #if RT_DEBUG >= 1
 
     /* asin/acos under debug as not used yet */
 
     rt_real asn_1[S];
-#define inf_ASN_1           DP(Q*0x200+0x100*P)
+#define inf_ASN_1           DP(Q*0x220+0x100*P)
 
     rt_real asn_2[S];
-#define inf_ASN_2           DP(Q*0x210+0x100*P)
+#define inf_ASN_2           DP(Q*0x230+0x100*P)
 
     rt_real asn_3[S];
-#define inf_ASN_3           DP(Q*0x220+0x100*P)
+#define inf_ASN_3           DP(Q*0x240+0x100*P)
 
     rt_real asn_4[S];
-#define inf_ASN_4           DP(Q*0x230+0x100*P)
+#define inf_ASN_4           DP(Q*0x250+0x100*P)
 
     rt_real tmp_1[S];
-#define inf_TMP_1           DP(Q*0x240+0x100*P)
+#define inf_TMP_1           DP(Q*0x260+0x100*P)
 
     rt_real tmp_2[S];
-#define inf_TMP_2           DP(Q*0x250+0x100*P)
+#define inf_TMP_2           DP(Q*0x270+0x100*P)
 
     rt_real tmp_3[S];
-#define inf_TMP_3           DP(Q*0x260+0x100*P)
+#define inf_TMP_3           DP(Q*0x280+0x100*P)
 
     rt_real tmp_4[S];
-#define inf_TMP_4           DP(Q*0x270+0x100*P)
+#define inf_TMP_4           DP(Q*0x290+0x100*P)
 
     rt_real pad12[S*8];
-#define inf_PAD12           DP(Q*0x280+0x100*P)
+#define inf_PAD12           DP(Q*0x2A0+0x100*P)
 
     /* quadric debug info */
 
     rt_real wmask[S];
-#define inf_WMASK           DP(Q*0x300+0x100*P)
+#define inf_WMASK           DP(Q*0x320+0x100*P)
 
 
     rt_real dff_x[S];
-#define inf_DFF_X           DP(Q*0x310+0x100*P)
+#define inf_DFF_X           DP(Q*0x330+0x100*P)
 
     rt_real dff_y[S];
-#define inf_DFF_Y           DP(Q*0x320+0x100*P)
+#define inf_DFF_Y           DP(Q*0x340+0x100*P)
 
     rt_real dff_z[S];
-#define inf_DFF_Z           DP(Q*0x330+0x100*P)
+#define inf_DFF_Z           DP(Q*0x350+0x100*P)
 
 
     rt_real ray_x[S];
-#define inf_RAY_X           DP(Q*0x340+0x100*P)
+#define inf_RAY_X           DP(Q*0x360+0x100*P)
 
     rt_real ray_y[S];
-#define inf_RAY_Y           DP(Q*0x350+0x100*P)
+#define inf_RAY_Y           DP(Q*0x370+0x100*P)
 
     rt_real ray_z[S];
-#define inf_RAY_Z           DP(Q*0x360+0x100*P)
+#define inf_RAY_Z           DP(Q*0x380+0x100*P)
 
 
     rt_real a_val[S];
-#define inf_A_VAL           DP(Q*0x370+0x100*P)
+#define inf_A_VAL           DP(Q*0x390+0x100*P)
 
     rt_real b_val[S];
-#define inf_B_VAL           DP(Q*0x380+0x100*P)
+#define inf_B_VAL           DP(Q*0x3A0+0x100*P)
 
     rt_real c_val[S];
-#define inf_C_VAL           DP(Q*0x390+0x100*P)
+#define inf_C_VAL           DP(Q*0x3B0+0x100*P)
 
     rt_real d_val[S];
-#define inf_D_VAL           DP(Q*0x3A0+0x100*P)
+#define inf_D_VAL           DP(Q*0x3C0+0x100*P)
 
 
     rt_real dmask[S];
-#define inf_DMASK           DP(Q*0x3B0+0x100*P)
+#define inf_DMASK           DP(Q*0x3D0+0x100*P)
 
 
     rt_real t1nmr[S];
-#define inf_T1NMR           DP(Q*0x3C0+0x100*P)
+#define inf_T1NMR           DP(Q*0x3E0+0x100*P)
 
     rt_real t1dnm[S];
-#define inf_T1DNM           DP(Q*0x3D0+0x100*P)
+#define inf_T1DNM           DP(Q*0x3F0+0x100*P)
 
     rt_real t2nmr[S];
-#define inf_T2NMR           DP(Q*0x3E0+0x100*P)
+#define inf_T2NMR           DP(Q*0x400+0x100*P)
 
     rt_real t2dnm[S];
-#define inf_T2DNM           DP(Q*0x3F0+0x100*P)
+#define inf_T2DNM           DP(Q*0x410+0x100*P)
 
 
     rt_real t1val[S];
-#define inf_T1VAL           DP(Q*0x400+0x100*P)
+#define inf_T1VAL           DP(Q*0x420+0x100*P)
 
     rt_real t2val[S];
-#define inf_T2VAL           DP(Q*0x410+0x100*P)
+#define inf_T2VAL           DP(Q*0x430+0x100*P)
 
     rt_real t1srt[S];
-#define inf_T1SRT           DP(Q*0x420+0x100*P)
+#define inf_T1SRT           DP(Q*0x440+0x100*P)
 
     rt_real t2srt[S];
-#define inf_T2SRT           DP(Q*0x430+0x100*P)
+#define inf_T2SRT           DP(Q*0x450+0x100*P)
 
     rt_real t1msk[S];
-#define inf_T1MSK           DP(Q*0x440+0x100*P)
+#define inf_T1MSK           DP(Q*0x460+0x100*P)
 
     rt_real t2msk[S];
-#define inf_T2MSK           DP(Q*0x450+0x100*P)
+#define inf_T2MSK           DP(Q*0x470+0x100*P)
 
 
     rt_real tside[S];
-#define inf_TSIDE           DP(Q*0x460+0x100*P)
+#define inf_TSIDE           DP(Q*0x480+0x100*P)
 
 
     rt_real hit_x[S];
-#define inf_HIT_X           DP(Q*0x470+0x100*P)
+#define inf_HIT_X           DP(Q*0x490+0x100*P)
 
     rt_real hit_y[S];
-#define inf_HIT_Y           DP(Q*0x480+0x100*P)
+#define inf_HIT_Y           DP(Q*0x4A0+0x100*P)
 
     rt_real hit_z[S];
-#define inf_HIT_Z           DP(Q*0x490+0x100*P)
+#define inf_HIT_Z           DP(Q*0x4B0+0x100*P)
 
 
     rt_real adj_x[S];
-#define inf_ADJ_X           DP(Q*0x4A0+0x100*P)
+#define inf_ADJ_X           DP(Q*0x4C0+0x100*P)
 
     rt_real adj_y[S];
-#define inf_ADJ_Y           DP(Q*0x4B0+0x100*P)
+#define inf_ADJ_Y           DP(Q*0x4D0+0x100*P)
 
     rt_real adj_z[S];
-#define inf_ADJ_Z           DP(Q*0x4C0+0x100*P)
+#define inf_ADJ_Z           DP(Q*0x4E0+0x100*P)
 
 
     rt_real nrm_x[S];
-#define inf_NRM_X           DP(Q*0x4D0+0x100*P)
+#define inf_NRM_X           DP(Q*0x4F0+0x100*P)
 
     rt_real nrm_y[S];
-#define inf_NRM_Y           DP(Q*0x4E0+0x100*P)
+#define inf_NRM_Y           DP(Q*0x500+0x100*P)
 
     rt_real nrm_z[S];
-#define inf_NRM_Z           DP(Q*0x4F0+0x100*P)
+#define inf_NRM_Z           DP(Q*0x510+0x100*P)
 
 
     rt_word q_dbg;
-#define inf_Q_DBG           DP(Q*0x500+0x100*P+E)
+#define inf_Q_DBG           DP(Q*0x520+0x100*P+E)
 
     rt_word q_cnt;
-#define inf_Q_CNT           DP(Q*0x500+0x104*P+E)
+#define inf_Q_CNT           DP(Q*0x520+0x104*P+E)
 
 #endif /* RT_DEBUG */
 };
@@ -1011,6 +1077,72 @@ struct rt_SIMD_LIGHT
     rt_real a_rng[S];
 #define lgt_A_RNG           DP(Q*0x0B0)
 
+    /* area light axes (scaled) */
+
+    rt_real u_x[S];
+#define lgt_U_X             DP(Q*0x0C0)
+
+    rt_real u_y[S];
+#define lgt_U_Y             DP(Q*0x0D0)
+
+    rt_real u_z[S];
+#define lgt_U_Z             DP(Q*0x0E0)
+
+    rt_real v_x[S];
+#define lgt_V_X             DP(Q*0x0F0)
+
+    rt_real v_y[S];
+#define lgt_V_Y             DP(Q*0x100)
+
+    rt_real v_z[S];
+#define lgt_V_Z             DP(Q*0x110)
+
+    rt_real w_x[S];
+#define lgt_W_X             DP(Q*0x120)
+
+    rt_real w_y[S];
+#define lgt_W_Y             DP(Q*0x130)
+
+    rt_real w_z[S];
+#define lgt_W_Z             DP(Q*0x140)
+
+    /* per-element sampling strata */
+
+    rt_real ofs_u[S];
+#define lgt_OFS_U           DP(Q*0x150)
+
+    rt_real ofs_v[S];
+#define lgt_OFS_V           DP(Q*0x160)
+
+    /* hit position hash coefficients */
+
+    rt_real hsh_x[S];
+#define lgt_HSH_X           DP(Q*0x170)
+
+    rt_real hsh_y[S];
+#define lgt_HSH_Y           DP(Q*0x180)
+
+    rt_real hsh_z[S];
+#define lgt_HSH_Z           DP(Q*0x190)
+
+    rt_real hsh_s[S];
+#define lgt_HSH_S           DP(Q*0x1A0)
+
+    /* PI constant for sphere sampling */
+
+    rt_real gpc01[S];
+#define lgt_GPC01           DP(Q*0x1B0)
+
+    /* light shape tag */
+
+    rt_si32 shp_t[2];
+#define lgt_SHP_T           DP(Q*0x1C0)
+
+    /* light's element offset in thread's occluder cache */
+
+    rt_word occ_o;
+#define lgt_OCC_O           DP(Q*0x1C0+0x008+E)
+
 };
 
 /******************************************************************************/
@@ -1019,166 +1151,244 @@ struct rt_SIMD_LIGHT
 
 /*
  * SIMD surface structure with properties.
+ * Fields used in intersection come first,
+ * followed by material/clipping fields.
  * Structure is read-only in backend.
  */
 struct rt_SIMD_SURFACE
 {
-    /* clipping accum default */
-
-    rt_elem c_def[S];
-#define srf_C_DEF           DP(Q*0x000)
-
     /* surface position */
 
     rt_real pos_x[S];
-#define srf_POS_X           DP(Q*0x010)
+#define srf_POS_X           DP(Q*0x000)
 
     rt_real pos_y[S];
-#define srf_POS_Y           DP(Q*0x020)
+#define srf_POS_Y           DP(Q*0x010)
 
     rt_real pos_z[S];
-#define srf_POS_Z           DP(Q*0x030)
-
-    /* axis min clippers */
-
-    rt_real min_x[S];
-#define srf_MIN_X           DP(Q*0x040)
-
-    rt_real min_y[S];
-#define srf_MIN_Y           DP(Q*0x050)
-
-    rt_real min_z[S];
-#define srf_MIN_Z           DP(Q*0x060)
-
-    /* axis max clippers */
-
-    rt_real max_x[S];
-#define srf_MAX_X           DP(Q*0x070)
-
-    rt_real max_y[S];
-#define srf_MAX_Y           DP(Q*0x080)
-
-    rt_real max_z[S];
-#define srf_MAX_Z           DP(Q*0x090)
-
-    /* axis clipping toggles (on/off) */
-
-    rt_si32 min_t[R];
-#define srf_MIN_T(nx)       DP(Q*0x0A0 + nx)
-
-    rt_si32 max_t[R];
-#define srf_MAX_T(nx)       DP(Q*0x0B0 + nx)
+#define srf_POS_Z           DP(Q*0x020)
 
     /* surface axis mapping */
 
     rt_si32 a_map[R];
-#define srf_A_MAP(nx)       DP(Q*0x0C0 + nx)
+#define srf_A_MAP(nx)       DP(Q*0x030 + nx)
 
     rt_si32 a_sgn[R];
-#define srf_A_SGN(nx)       DP(Q*0x0D0 + nx)
+#define srf_A_SGN(nx)       DP(Q*0x040 + nx)
 
     /* sign masks */
 
     rt_uelm sbase[S];
-#define srf_SBASE           DP(Q*0x0E0)
+#define srf_SBASE           DP(Q*0x050)
 
     rt_uelm smask[S];
-#define srf_SMASK           DP(Q*0x0F0)
+#define srf_SMASK           DP(Q*0x060)
 
     /* root sorting thresholds */
 
     rt_real d_eps[S];
-#define srf_D_EPS           DP(Q*0x100)
+#define srf_D_EPS           DP(Q*0x070)
 
     rt_real t_eps[S];
-#define srf_T_EPS           DP(Q*0x110)
-
-    /* surface pointers */
-
-    rt_uelm srf_p[S];
-#define srf_SRF_P           DP(Q*0x120)
-
-    rt_uelm srf_h[S];
-#define srf_SRF_H           DP(Q*0x130)
+#define srf_T_EPS           DP(Q*0x080)
 
     /* transform coeffs */
 
     rt_real tci_x[S];
-#define srf_TCI_X           DP(Q*0x140)
+#define srf_TCI_X           DP(Q*0x090)
 
     rt_real tci_y[S];
-#define srf_TCI_Y           DP(Q*0x150)
+#define srf_TCI_Y           DP(Q*0x0A0)
 
     rt_real tci_z[S];
-#define srf_TCI_Z           DP(Q*0x160)
+#define srf_TCI_Z           DP(Q*0x0B0)
 
 
     rt_real tcj_x[S];
-#define srf_TCJ_X           DP(Q*0x170)
+#define srf_TCJ_X           DP(Q*0x0C0)
 
     rt_real tcj_y[S];
-#define srf_TCJ_Y           DP(Q*0x180)
+#define srf_TCJ_Y           DP(Q*0x0D0)
 
     rt_real tcj_z[S];
-#define srf_TCJ_Z           DP(Q*0x190)
+#define srf_TCJ_Z           DP(Q*0x0E0)
 
 
     rt_real tck_x[S];
-#define srf_TCK_X           DP(Q*0x1A0)
+#define srf_TCK_X           DP(Q*0x0F0)
 
     rt_real tck_y[S];
-#define srf_TCK_Y           DP(Q*0x1B0)
+#define srf_TCK_Y           DP(Q*0x100)
 
     rt_real tck_z[S];
-#define srf_TCK_Z           DP(Q*0x1C0)
+#define srf_TCK_Z           DP(Q*0x110)
 
     /* geometry scaling coeffs */
 
-#define srf_SCI_O           DP(Q*0x1D0)
+#define srf_SCI_O           DP(Q*0x120)
 
     rt_real sci_x[S];
-#define srf_SCI_X           DP(Q*0x1D0)
+#define srf_SCI_X           DP(Q*0x120)
 
     rt_real sci_y[S];
-#define srf_SCI_Y           DP(Q*0x1E0)
+#define srf_SCI_Y           DP(Q*0x130)
 
     rt_real sci_z[S];
-#define srf_SCI_Z           DP(Q*0x1F0)
+#define srf_SCI_Z           DP(Q*0x140)
 
     rt_real sci_w[S];
-#define srf_SCI_W           DP(Q*0x200)
+#define srf_SCI_W           DP(Q*0x150)
 
 
     rt_real scj_x[S];
-#define srf_SCJ_X           DP(Q*0x210)
+#define srf_SCJ_X           DP(Q*0x160)
 
     rt_real scj_y[S];
-#define srf_SCJ_Y           DP(Q*0x220)
+#define srf_SCJ_Y           DP(Q*0x170)
 
     rt_real scj_z[S];
-#define srf_SCJ_Z           DP(Q*0x230)
+#define srf_SCJ_Z           DP(Q*0x180)
+
+    /* misc tags/pointers */
+
+    rt_si32 srf_t[4];
+#define srf_SRF_T(nx)       DP(Q*0x190 + nx)
+
+    rt_pntr msc_p[4];
+#define srf_MSC_P(nx)       DP(Q*0x190+0x010+0x000*P+E + (nx)*P)
+
+    rt_pntr mat_p[4];
+#define srf_MAT_P(nx)       DP(Q*0x190+0x010+0x010*P+E + (nx)*P)
+
+    rt_pntr lst_p[4];
+#define srf_LST_P(nx)       DP(Q*0x190+0x010+0x020*P+E + (nx)*P)
+
+    /* align to the next SIMD-field */
+
+    rt_si32 pad01[R*8-4-P*12];
+#define srf_PAD01           DP(Q*0x190+0x010+0x030*P)
+
+    /* clipping accum default */
+
+    rt_elem c_def[S];
+#define srf_C_DEF           DP(Q*0x210)
+
+    /* axis min clippers */
+
+    rt_real min_x[S];
+#define srf_MIN_X           DP(Q*0x220)
+
+    rt_real min_y[S];
+#define srf_MIN_Y           DP(Q*0x230)
+
+    rt_real min_z[S];
+#define srf_MIN_Z           DP(Q*0x240)
+
+    /* axis max clippers */
+
+    rt_real max_x[S];
+#define srf_MAX_X           DP(Q*0x250)
+
+    rt_real max_y[S];
+#define srf_MAX_Y           DP(Q*0x260)
+
+    rt_real max_z[S];
+#define srf_MAX_Z           DP(Q*0x270)
+
+    /* axis clipping toggles (on/off) */
+
+    rt_si32 min_t[R];
+#define srf_MIN_T(nx)       DP(Q*0x280 + nx)
+
+    rt_si32 max_t[R];
+#define srf_MAX_T(nx)       DP(Q*0x290 + nx)
+
+    /* surface pointers */
+
+    rt_uelm srf_p[S];
+#define srf_SRF_P           DP(Q*0x2A0)
+
+    rt_uelm srf_h[S];
+#define srf_SRF_H           DP(Q*0x2B0)
 
     /* surface sides */
 
     rt_elem srf_o[S];
-#define srf_SRF_O           DP(Q*0x240)
+#define srf_SRF_O           DP(Q*0x2C0)
 
     rt_elem srf_i[S];
-#define srf_SRF_I           DP(Q*0x250)
+#define srf_SRF_I           DP(Q*0x2D0)
 
-    /* misc tags/pointers */
+};
 
-    rt_si32 srf_t[4];
-#define srf_SRF_T(nx)       DP(Q*0x260 + nx)
+/*
+ * SIMD distance field structure with properties,
+ * extends surface structure with sphere tracing parameters.
+ * Structure is read-only in backend.
+ */
+struct rt_SIMD_DISTFIELD : public rt_SIMD_SURFACE
+{
+    /* box half-sizes (minus rounding) */
 
-    rt_pntr msc_p[4];
-#define srf_MSC_P(nx)       DP(Q*0x260+0x010+0x000*P+E + (nx)*P)
+    rt_real box_x[S];
+#define sdf_BOX_X           DP(Q*0x2E0)
 
-    rt_pntr mat_p[4];
-#define srf_MAT_P(nx)       DP(Q*0x260+0x010+0x010*P+E + (nx)*P)
+    rt_real box_y[S];
+#define sdf_BOX_Y           DP(Q*0x2F0)
 
-    rt_pntr lst_p[4];
-#define srf_LST_P(nx)       DP(Q*0x260+0x010+0x020*P+E + (nx)*P)
+    rt_real box_z[S];
+#define sdf_BOX_Z           DP(Q*0x300)
+
+    rt_real box_r[S];
+#define sdf_BOX_R           DP(Q*0x310)
+
+    /* sphere radius */
+
+    rt_real sph_r[S];
+#define sdf_SPH_R           DP(Q*0x320)
+
+    /* smooth blending coeffs */
+
+    rt_real bld_k[S];
+#define sdf_BLD_K           DP(Q*0x330)
+
+    rt_real bld_q[S];
+#define sdf_BLD_Q           DP(Q*0x340)
+
+    /* CSG sign masks */
+
+    rt_uelm sgn_a[S];
+#define sdf_SGN_A           DP(Q*0x350)
+
+    rt_uelm sgn_b[S];
+#define sdf_SGN_B           DP(Q*0x360)
+
+    /* fractal scaling coeffs */
+
+    rt_real m_inv[S];
+#define sdf_M_INV           DP(Q*0x370)
+
+    rt_real m_fin[S];
+#define sdf_M_FIN           DP(Q*0x380)
+
+    /* marching thresholds */
+
+    rt_real h_eps[S];
+#define sdf_H_EPS           DP(Q*0x390)
+
+    rt_real t_off[S];
+#define sdf_T_OFF           DP(Q*0x3A0)
+
+    rt_real b_rad[S];
+#define sdf_B_RAD           DP(Q*0x3B0)
+
+    rt_real n_eps[S];
+#define sdf_N_EPS           DP(Q*0x3C0)
+
+    /* kind, steps, iterations */
+
+    rt_si32 sdf_t[R];
+#define sdf_SDF_T(nx)       DP(Q*0x3D0 + nx)
 
 };
 
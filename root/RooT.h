@@ -94,6 +94,13 @@ rt_bool     q_test      = RT_FALSE;       /* quake mode (from actual scene) */
 rt_si32     u_mode      = 0; /* update/render threadoff (from command-line) */
 rt_bool     o_mode      = RT_FALSE;        /* offscreen (from command-line) */
 rt_si32     a_mode      = RT_FSAA_NO;      /* FSAA mode (from command-line) */
+rt_si32     j_size      = 0;    /* trace-ring size (from command-line) */
+rt_pstr     v_file      = RT_NULL;  /* record-input file (from command-line) */
+rt_pstr     z_file      = RT_NULL;  /* replay-input file (from command-line) */
+rt_bool     y_pipe      = RT_FALSE; /* pipelined replay (from command-line) */
+rt_bool     y_bat       = RT_FALSE; /* all-scene replay (from command-line) */
+volatile
+rt_si32     j_dump      = 0;    /* trace-dump request (from signal/key) */
 
 /******************************************************************************/
 /********************************   PLATFORM   ********************************/
@@ -232,6 +239,7 @@ rt_si32 glb = 0;
 rt_real avg = 0.0f;
 rt_si32 ttl = 0;
 rt_si32 scr_id = 0;
+rt_si32 trc_id = 0;
 
 /* virtual key arrays */
 rt_byte r_to_p[KEY_MASK + 1];
@@ -296,6 +304,60 @@ rt_void print_target()
                     RT_POINTER, RT_ADDRESS == 32 ? "_" : "f", RT_ELEMENT);
 }
 
+/******************************************************************************/
+/********************************   RECORDER   ********************************/
+/******************************************************************************/
+
+#define RT_REC_FRAME        0   /* render frame at record's time */
+#define RT_REC_ACTION       1   /* apply camera action "arg" at record's time */
+#define RT_REC_SCENE        2   /* switch to demo-scene "arg" */
+#define RT_REC_CAMERA       3   /* switch to next camera ("arg" is new idx) */
+
+#define RT_REC_MAGIC        0x50525452 /* "RTRP" (little-endian) */
+
+/*
+ * Input-record structure (8 bytes), the file starts with a header record
+ * holding the magic in "time", initial demo-scene in "type" and
+ * initial camera-idx in "arg", followed by records in the order of events.
+ */
+struct rt_RECORD
+{
+    rt_ui16             type;
+    rt_ui16             arg;
+    rt_ui32             time;   /* animation time (ms) */
+};
+
+rt_File    *rec = RT_NULL;  /* input-record file (RT_NULL - not recording) */
+
+/*
+ * Append event to the input-record file (if recording).
+ */
+rt_void rec_event(rt_si32 type, rt_si32 arg, rt_time time)
+{
+    if (rec == RT_NULL)
+    {
+        return;
+    }
+
+    rt_RECORD r;
+
+    r.type = (rt_ui16)type;
+    r.arg  = (rt_ui16)arg;
+    r.time = (rt_ui32)time;
+
+    rec->save(&r, sizeof(rt_RECORD), 1);
+}
+
+/*
+ * Apply camera "action" to current scene and record it.
+ */
+rt_void scene_action(rt_si32 action)
+{
+    sc[d]->update(anim_time, action);
+
+    rec_event(RT_REC_ACTION, action, anim_time);
+}
+
 rt_pstr str = "--------------------------------------------------------";
 
 /*
@@ -317,6 +379,11 @@ rt_si32 main_step()
             sc[d]->save_frame(scr_id++);
             switched = 1;
         }
+        if (T_KEYS(RK_F9) || T_KEYS(RK_X) || j_dump)
+        {
+            j_dump = 0;
+            pfm->save_trace(trc_id++);
+        }
         if (T_KEYS(RK_F5) || T_KEYS(RK_L))
         {
             l_mode = !l_mode;
@@ -535,15 +602,15 @@ rt_si32 main_step()
         { /* -->---->-- skip update0 -->---->-- */
 #endif /* RT_OPTS_UPDATE_EXT0 */
 
-        if (H_KEYS(RK_W))     sc[d]->update(anim_time, RT_CAMERA_MOVE_FORWARD);
-        if (H_KEYS(RK_S))     sc[d]->update(anim_time, RT_CAMERA_MOVE_BACK);
-        if (H_KEYS(RK_A))     sc[d]->update(anim_time, RT_CAMERA_MOVE_LEFT);
-        if (H_KEYS(RK_D))     sc[d]->update(anim_time, RT_CAMERA_MOVE_RIGHT);
+        if (H_KEYS(RK_W))     scene_action(RT_CAMERA_MOVE_FORWARD);
+        if (H_KEYS(RK_S))     scene_action(RT_CAMERA_MOVE_BACK);
+        if (H_KEYS(RK_A))     scene_action(RT_CAMERA_MOVE_LEFT);
+        if (H_KEYS(RK_D))     scene_action(RT_CAMERA_MOVE_RIGHT);
 
-        if (H_KEYS(RK_UP))    sc[d]->update(anim_time, RT_CAMERA_ROTATE_DOWN);
-        if (H_KEYS(RK_DOWN))  sc[d]->update(anim_time, RT_CAMERA_ROTATE_UP);
-        if (H_KEYS(RK_LEFT))  sc[d]->update(anim_time, RT_CAMERA_ROTATE_LEFT);
-        if (H_KEYS(RK_RIGHT)) sc[d]->update(anim_time, RT_CAMERA_ROTATE_RIGHT);
+        if (H_KEYS(RK_UP))    scene_action(RT_CAMERA_ROTATE_DOWN);
+        if (H_KEYS(RK_DOWN))  scene_action(RT_CAMERA_ROTATE_UP);
+        if (H_KEYS(RK_LEFT))  scene_action(RT_CAMERA_ROTATE_LEFT);
+        if (H_KEYS(RK_RIGHT)) scene_action(RT_CAMERA_ROTATE_RIGHT);
 
         if (T_KEYS(RK_F1) || T_KEYS(RK_I))
         {
@@ -560,6 +627,7 @@ rt_si32 main_step()
         {
             c_prev = c;
             c = sc[d]->next_cam();
+            rec_event(RT_REC_CAMERA, c, anim_time);
             switched = c_prev != c ? 1 : switched;
         }
         if (T_KEYS(RK_F6) || T_KEYS(RK_6))
@@ -654,6 +722,7 @@ rt_si32 main_step()
             d = (d + 1) % RT_ARR_SIZE(sc_rt);
             c = sc[d]->get_cam_idx();
             pfm->set_cur_scene(sc[d]);
+            rec_event(RT_REC_SCENE, d, anim_time);
             switched = d_prev != d ? 1 : switched;
             q_prev = q_test;
             q_test = sc[d]->set_pton(q_mode ? m_num : 0) > 0 ? q_mode : 0;
@@ -723,7 +792,11 @@ rt_si32 main_step()
         cnt++;
         ttl++;
 
-        sc[d]->render(f_time >= 0 ? b_time + f_time * ttl : anim_time);
+        rt_time time = f_time >= 0 ? b_time + f_time * ttl : anim_time;
+
+        rec_event(RT_REC_FRAME, 0, time);
+
+        sc[d]->render(time);
 
         if (!h_mode)
         {
@@ -758,7 +831,11 @@ rt_si32 main_step()
 
     if (!o_mode)
     {
+        rt_time time = get_usec();
+
         frame_to_screen(sc[d]->get_frame(), sc[d]->get_x_row());
+
+        pfm->add_trace("frame to screen", time);
     }
 
     return 1;
@@ -801,7 +878,12 @@ rt_si32 args_init(rt_si32 argc, rt_char *argv[])
         RT_LOGI(" -o, offscreen-frame mode, turns off window-rect updates\n");
         RT_LOGI(" -a, enable 4x antialiasing by default, 8x not supported\n");
         RT_LOGI(" -a n, enable antialiasing, 2 for 2x, 4 for 4x, 8 for 8x\n");
-        RT_LOGI("options -d n  ... ... ... ... ...  -a n can all be mixed\n");
+        RT_LOGI(" -j n, event tracing, n events per thread, F9/X dumps it\n");
+        RT_LOGI(" --rec file, record camera/scene input stream into file\n");
+        RT_LOGI(" --play file, replay recorded input headless, full speed\n");
+        RT_LOGI(" --pipe, replay overlapping update with previous render\n");
+        RT_LOGI(" --batch, replay rendering all scenes in every frame\n");
+        RT_LOGI("options -d n  ... ... ... ... ...  -j n can all be mixed\n");
         RT_LOGI("--------------------------------------------------------\n");
     }
 
@@ -1178,6 +1260,43 @@ rt_si32 args_init(rt_si32 argc, rt_char *argv[])
             }
             RT_LOGI("Antialiasing request: %d\n", 1 << a_mode);
         }
+        if (k < argc && strcmp(argv[k], "-j") == 0 && ++k < argc)
+        {
+            for (l = strlen(argv[k]), r = 1, t = 0; l > 0; l--, r *= 10)
+            {
+                t += (argv[k][l-1] - '0') * r;
+            }
+            if (t >= 1 && t <= 10000000)
+            {
+                RT_LOGI("Event-tracing ring size: %d\n", t);
+                j_size = t;
+            }
+            else
+            {
+                RT_LOGI("Event-tracing ring size value out of range\n");
+                return 0;
+            }
+        }
+        if (k < argc && strcmp(argv[k], "--rec") == 0 && ++k < argc)
+        {
+            RT_LOGI("Record-input file: %s\n", argv[k]);
+            v_file = argv[k];
+        }
+        if (k < argc && strcmp(argv[k], "--play") == 0 && ++k < argc)
+        {
+            RT_LOGI("Replay-input file: %s\n", argv[k]);
+            z_file = argv[k];
+        }
+        if (k < argc && strcmp(argv[k], "--pipe") == 0 && !y_pipe)
+        {
+            y_pipe = RT_TRUE;
+            RT_LOGI("Pipelined replay: %d\n", y_pipe);
+        }
+        if (k < argc && strcmp(argv[k], "--batch") == 0 && !y_bat)
+        {
+            y_bat = RT_TRUE;
+            RT_LOGI("Batched replay: %d\n", y_bat);
+        }
     }
 
     x_res = x_res * (w_size != 0 ? w_size : 1);
@@ -1219,6 +1338,16 @@ rt_si32 main_init()
     }
     tile_w = pfm->get_tile_w();
 
+    try
+    {
+        pfm->set_trace(j_size);
+    }
+    catch (rt_Exception e)
+    {
+        RT_LOGE("Exception in main_init, platform: %s\n", e.err);
+        return 0;
+    }
+
     try
     {
         for (i = 0; i < n; i++)
@@ -1306,6 +1435,20 @@ rt_si32 main_init()
     p_prev = p_mode;
     q_prev = q_mode;
 
+    /* start input-record file with initial scene/camera */
+    if (v_file != RT_NULL && z_file == RT_NULL)
+    {
+        rec = new rt_File(v_file, "wb");
+        if (rec->error() != 0)
+        {
+            RT_LOGE("Cannot open %s for recording\n", v_file);
+            delete rec;
+            rec = RT_NULL;
+            return 0;
+        }
+        rec_event(d, c, RT_REC_MAGIC);
+    }
+
     print_target();
 
     return 1;
@@ -1323,6 +1466,12 @@ rt_si32 main_term()
 
     print_avgfps();
 
+    if (rec != RT_NULL)
+    {
+        delete rec;
+        rec = RT_NULL;
+    }
+
     rt_si32 i, n = RT_ARR_SIZE(sc_rt);
 
     try
@@ -1349,6 +1498,179 @@ rt_si32 main_term()
     return 1;
 }
 
+/*
+ * Replay input-record file at full speed without a window,
+ * print percentiles of frame times at the end.
+ */
+rt_si32 main_play()
+{
+    rt_File fl(z_file, "rb");
+    rt_File *f = &fl;
+    rt_RECORD r;
+
+    if (f->error() != 0 || f->load(&r, sizeof(rt_RECORD), 1) != 1
+    ||  r.time != RT_REC_MAGIC || r.type >= RT_ARR_SIZE(sc_rt))
+    {
+        RT_LOGE("Cannot open %s for replay\n", z_file);
+        return 0;
+    }
+
+    /* recorded initial scene/camera take precedence over -d/-c */
+    d = r.type;
+    c = r.arg;
+
+    /* count records and frames, then load all records at once */
+    rt_si32 i, j, k, n = 0, m = 0;
+    rt_time tms[RT_ARR_SIZE(sc_rt)];
+
+    while (f->load(&r, sizeof(rt_RECORD), 1) == 1)
+    {
+        m += r.type == RT_REC_FRAME ? 1 : 0;
+        n++;
+    }
+
+    if (m == 0)
+    {
+        RT_LOGE("No frames to replay in %s\n", z_file);
+        return 0;
+    }
+
+    rt_size size = n * sizeof(rt_RECORD) + m * sizeof(rt_time);
+    rt_RECORD *recs = (rt_RECORD *)sys_alloc(size);
+    rt_time *frms = (rt_time *)(recs + n);
+
+    if (f->seek(sizeof(rt_RECORD), SEEK_SET) != 0
+    ||  f->load(recs, sizeof(rt_RECORD), n) != (rt_size)n)
+    {
+        RT_LOGE("Cannot load %s for replay\n", z_file);
+        sys_free(recs, size);
+        return 0;
+    }
+
+    if (main_init() == 0)
+    {
+        sys_free(recs, size);
+        return 0;
+    }
+
+    /* path-tracer accumulates frames in place, not pipelined */
+    for (j = 0; j < RT_ARR_SIZE(sc_rt); j++)
+    {
+        sc[j]->set_pipe(y_pipe && !y_bat && !q_mode);
+    }
+
+    rt_time time = get_usec();
+
+    try
+    {
+        for (i = 0, k = 0; i < n && eout == 0; i++)
+        {
+            switch (recs[i].type)
+            {
+                case RT_REC_FRAME:
+                frms[k] = get_usec();
+                if (y_bat)
+                {
+                    /* render all scenes in one dispatch of the pool,
+                     * input is only applied to the current one */
+                    for (j = 0; j < RT_ARR_SIZE(sc_rt); j++)
+                    {
+                        tms[j] = recs[i].time;
+                    }
+                    pfm->render_batch(RT_ARR_SIZE(sc_rt), sc, tms);
+                }
+                else
+                if (sc[d]->get_pipe())
+                {
+                    /* update the frame while previous one is rendering,
+                     * frame times are measured between finished frames */
+                    sc[d]->prepare(recs[i].time);
+                    sc[d]->render_wait();
+                    sc[d]->render_post();
+                }
+                else
+                {
+                    sc[d]->render(recs[i].time);
+                }
+                frms[k] = get_usec() - frms[k];
+                k++;
+                break;
+
+                case RT_REC_ACTION:
+                sc[d]->update(recs[i].time, recs[i].arg);
+                break;
+
+                case RT_REC_SCENE:
+                sc[d]->render_wait();
+                d = recs[i].arg % RT_ARR_SIZE(sc_rt);
+                pfm->set_cur_scene(sc[d]);
+                q_test = sc[d]->set_pton(q_mode ? m_num : 0) > 0 ? q_mode : 0;
+                break;
+
+                case RT_REC_CAMERA:
+                c = sc[d]->next_cam();
+                break;
+
+                default:
+                break;
+            }
+        }
+    }
+    catch (rt_Exception e)
+    {
+        RT_LOGE("Exception: %s\n", e.err);
+    }
+
+    /* finish the last pipelined frame */
+    sc[d]->render_wait();
+
+    time = get_usec() - time;
+
+    /* shell sort of frame times for percentiles */
+    for (m = k / 2; m > 0; m /= 2)
+    {
+        for (i = m; i < k; i++)
+        {
+            rt_time t = frms[i];
+
+            for (j = i; j >= m && frms[j-m] > t; j -= m)
+            {
+                frms[j] = frms[j-m];
+            }
+
+            frms[j] = t;
+        }
+    }
+
+    if (k > 0)
+    {
+        RT_LOGI("%s\n", str);
+        RT_LOGI("Replayed frames = %d, records = %d, time (ms) = %ld\n",
+                                          k, n, (long)(time / 1000));
+        RT_LOGI("Frame time (usec): p50 = %ld, p90 = %ld, p99 = %ld\n",
+                              (long)frms[(k - 1) * 50 / 100],
+                              (long)frms[(k - 1) * 90 / 100],
+                              (long)frms[(k - 1) * 99 / 100]);
+        RT_LOGI("Frame time (usec): min = %ld, max = %ld\n",
+                              (long)frms[0], (long)frms[k - 1]);
+    }
+
+    if (j_size > 0)
+    {
+        pfm->save_trace(trc_id++);
+    }
+
+    sys_free(recs, size);
+
+    /* let main_term report average fps over the replay */
+    glb = 0;
+    cnt = k;
+    run_time = 0;
+    cur_time = time / 1000;
+
+    return main_term();
+}
+
 #endif /* RT_ROOT_H */
 
 /******************************************************************************/
@@ -38,6 +38,7 @@ GC          gc;
 XGCValues   gc_values   = {0};
 
 #include <pthread.h>
+#include <signal.h>
 
 pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
@@ -124,6 +125,14 @@ rt_si32 main_init();
 rt_si32 main_loop();
 rt_si32 main_term();
 
+/*
+ * Request trace dump at the next main step (SIGUSR1 handler).
+ */
+rt_void trace_signal(int sig)
+{
+    j_dump = 1;
+}
+
 /*
  * Program's main entry point.
  */
@@ -197,6 +206,21 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
         return 1;
     }
 
+    /* request trace dump on SIGUSR1 (if enabled) */
+    if (j_size > 0)
+    {
+        signal(SIGUSR1, trace_signal);
+    }
+
+    /* replay input-record file without X server */
+    if (z_file != RT_NULL)
+    {
+        pthread_mutex_init(&mutex, NULL);
+        ret = main_play();
+        pthread_mutex_destroy(&mutex);
+        return ret != 0 ? 0 : 1;
+    }
+
     /* open connection to X server */
     disp = XOpenDisplay(NULL);
     if (disp == NULL)
@@ -616,8 +640,8 @@ rt_pntr worker_thread(rt_pntr p)
                 scene->update_slice(ti, (cmd >> 2) & 0xFF);
                 break;
 
-                case 2:
-                scene->render_slice(ti, (cmd >> 2) & 0xFF);
+                case 2: /* current scene or platform's render batch */
+                pfm->render_slice(ti, (cmd >> 2) & 0xFF);
                 break;
 
                 default:
@@ -630,8 +654,13 @@ rt_pntr worker_thread(rt_pntr p)
             eout = 1;
         }
 
+        rt_time time = get_usec();
+
         /* every worker-thread signals to main thread when done */
         pthread_barrier_wait(&thread->tpool->barr[1]);
+
+        trace_event(pfm->get_trace(ti + 1), "barrier",
+                    time, get_usec() - time, 0);
     }
 
     /* every worker-thread signals to main thread when done */
@@ -790,17 +819,24 @@ rt_void update_scene(rt_pntr tdata, rt_si32 thnum, rt_si32 phase)
 
 /*
  * Task platform-specific pool of "thnum" threads to render scene,
- * block until finished.
+ * block until finished, unless RT_RENDER_POST is set in "phase",
+ * in which case a later call with RT_RENDER_WAIT blocks instead.
  */
 rt_void render_scene(rt_pntr tdata, rt_si32 thnum, rt_si32 phase)
 {
     rt_THREAD_POOL *tpool = (rt_THREAD_POOL *)tdata;
 
-    /* signal all worker-threads to render scene */
-    tpool->cmd = 2 | ((phase & 0xFF) << 2);
-    pthread_barrier_wait(&tpool->barr[0]);
-    /* wait for all worker-threads to finish */
-    pthread_barrier_wait(&tpool->barr[1]);
+    if ((phase & RT_RENDER_WAIT) == 0)
+    {
+        /* signal all worker-threads to render scene */
+        tpool->cmd = 2 | ((phase & 0xFF) << 2);
+        pthread_barrier_wait(&tpool->barr[0]);
+    }
+    if ((phase & RT_RENDER_POST) == 0)
+    {
+        /* wait for all worker-threads to finish */
+        pthread_barrier_wait(&tpool->barr[1]);
+    }
 }
 
 /******************************************************************************/
@@ -127,6 +127,15 @@ int APIENTRY WinMain(HINSTANCE hInstance,
         return FALSE;
     }
 
+    /* replay input-record file without window */
+    if (z_file != RT_NULL)
+    {
+        InitializeCriticalSection(&critSec);
+        ret = main_play();
+        DeleteCriticalSection(&critSec);
+        return ret != 0 ? TRUE : FALSE;
+    }
+
     /* register window class */
     MSG msg;
     hInst = hInstance;
@@ -450,8 +459,8 @@ DWORD WINAPI worker_thread(rt_pntr p)
                 scene->update_slice(ti, (cmd >> 2) & 0xFF);
                 break;
 
-                case 2:
-                scene->render_slice(ti, (cmd >> 2) & 0xFF);
+                case 2: /* current scene or platform's render batch */
+                pfm->render_slice(ti, (cmd >> 2) & 0xFF);
                 break;
 
                 default:
@@ -475,10 +484,15 @@ DWORD WINAPI worker_thread(rt_pntr p)
          * signals its respective control-event for the main thread */
         if ((ti % TG) == 0)
         {
+            rt_time time = get_usec();
+
             WaitForMultipleObjects(RT_MIN(TG, thread->tpool->thnum - ti),
                                    thread->tpool->pevent + (ti / TG) * TG,
                                    TRUE, INFINITE);
 
+            trace_event(pfm->get_trace(ti + 1), "barrier",
+                        time, get_usec() - time, 0);
+
             SetEvent(thread->tpool->cevent[ti / TG]);
         }
     }
@@ -816,21 +830,29 @@ rt_void update_scene(rt_pntr tdata, rt_si32 thnum, rt_si32 phase)
 
 /*
  * Task platform-specific pool of "thnum" threads to render scene,
- * block until finished.
+ * block until finished, unless RT_RENDER_POST is set in "phase",
+ * in which case a later call with RT_RENDER_WAIT blocks instead.
  */
 rt_void render_scene(rt_pntr tdata, rt_si32 thnum, rt_si32 phase)
 {
     rt_THREAD_POOL *tpool = (rt_THREAD_POOL *)tdata;
 
-    /* signal worker-event for all worker-threads to render scene */
-    tpool->cmd = 2 | ((phase & 0xFF) << 2);
-    SetEvent(tpool->wevent[tpool->windex]);
-    /* wait for control-threads to signal control-events for their groups */
-    WaitForMultipleObjects((thnum + TG-1) / TG, tpool->cevent, TRUE, INFINITE);
-    /* manually reset current worker-event */
-    ResetEvent(tpool->wevent[tpool->windex]);
-    /* swap worker-event for the main thread to signal */
-    tpool->windex = 1 - tpool->windex;
+    if ((phase & RT_RENDER_WAIT) == 0)
+    {
+        /* signal worker-event for all worker-threads to render scene */
+        tpool->cmd = 2 | ((phase & 0xFF) << 2);
+        SetEvent(tpool->wevent[tpool->windex]);
+    }
+    if ((phase & RT_RENDER_POST) == 0)
+    {
+        /* wait for control-threads to signal control-events for groups */
+        WaitForMultipleObjects((thnum + TG-1) / TG, tpool->cevent, TRUE,
+                                                                INFINITE);
+        /* manually reset current worker-event */
+        ResetEvent(tpool->wevent[tpool->windex]);
+        /* swap worker-event for the main thread to signal */
+        tpool->windex = 1 - tpool->windex;
+    }
 }
 
 /******************************************************************************/
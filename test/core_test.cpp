@@ -4,6 +4,7 @@
 /* file COPYING or http://www.opensource.org/licenses/mit-license.php         */
 /******************************************************************************/
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -14,7 +15,7 @@
 /*******************************   DEFINITIONS   ******************************/
 /******************************************************************************/
 
-#define SUB_TEST            18
+#define SUB_TEST            21
 #define CYC_SIZE            3
 
 #define RT_X_RES            800
@@ -40,6 +41,7 @@ rt_si32     x_res       = RT_X_RES;
 rt_si32     y_res       = RT_Y_RES;
 rt_si32     x_row       = (RT_X_RES+RT_SIMD_WIDTH-1) & ~(RT_SIMD_WIDTH-1);
 rt_ui32    *frame       = RT_NULL;
+rt_ui32    *pframe      = RT_NULL;
 
 rt_Scene   *scene       = RT_NULL;
 
@@ -61,6 +63,17 @@ rt_bool     l_mode      = RT_FALSE;     /* log-off mode (from command-line) */
 rt_bool     o_mode      = RT_FALSE;     /* optimal mode (from command-line) */
 rt_bool     q_mode      = RT_FALSE;     /* quality mode (from command-line) */
 rt_bool     q_test      = RT_FALSE;     /* quality mode (from actual scene) */
+rt_bool     m_mode      = RT_FALSE;     /* profile mode (from command-line) */
+rt_si32     u_mode      = 0;            /* autotune mode (from command-line) */
+rt_si32     b_mode      = 0;            /* benchmark mode (max surfaces num) */
+rt_si32     r_reps      = 1;        /* median-of-N repeats (from command-line) */
+rt_pstr     j_file      = RT_NULL;  /* JSON results file (from command-line) */
+rt_pstr     c_file      = RT_NULL;  /* JSON compare file (from command-line) */
+rt_si32     c_thrs      = 10;       /* slowdown threshold % (from command-line) */
+rt_si32     j_ring      = 0;        /* trace-ring size (from command-line) */
+rt_bool     y_pipe      = RT_FALSE;    /* pipeline mode (from command-line) */
+rt_time     t_runN[SUB_TEST];       /* unoptimized run times (ms), -1 if none */
+rt_time     t_runF[SUB_TEST];       /* optimized run times (ms), -1 if none */
 rt_si32     a_mode      = RT_FSAA_NO;   /* antialiasing (from command-line) */
 
 /*
@@ -186,6 +199,18 @@ rt_void frame_max(rt_ui32 *fd)
  */
 rt_Platform pfm(sys_alloc, sys_free);
 
+/*
+ * Pick the fastest SIMD target for current scene (autotune mode).
+ */
+rt_void tune_run()
+{
+    rt_si32 simd = scene->tune_simd(0, u_mode);
+
+    if (!l_mode)
+    RT_LOGI("SIMD autotuned = %4dx%dv%d\n", (simd & 0xFF) * 128,
+                                (simd >> 16) & 0xFF, (simd >> 8) & 0xFF);
+}
+
 /******************************************************************************/
 /*******************************   SUB TEST  1   ******************************/
 /******************************************************************************/
@@ -474,6 +499,54 @@ rt_void o_test18()
 
 #endif /* SUB_TEST 18 */
 
+/******************************************************************************/
+/*******************************   SUB TEST 19   ******************************/
+/******************************************************************************/
+
+#if SUB_TEST >= 19
+
+#include "scn_test19.h"
+
+rt_void o_test19()
+{
+    scene = new(&pfm) rt_Scene(&scn_test19::sc_root,
+                               x_res, y_res, x_row, RT_NULL, &pfm);
+}
+
+#endif /* SUB_TEST 19 */
+
+/******************************************************************************/
+/*******************************   SUB TEST 20   ******************************/
+/******************************************************************************/
+
+#if SUB_TEST >= 20
+
+#include "scn_test20.h"
+
+rt_void o_test20()
+{
+    scene = new(&pfm) rt_Scene(&scn_test20::sc_root,
+                               x_res, y_res, x_row, RT_NULL, &pfm);
+}
+
+#endif /* SUB_TEST 20 */
+
+/******************************************************************************/
+/*******************************   SUB TEST 21   ******************************/
+/******************************************************************************/
+
+#if SUB_TEST >= 21
+
+#include "scn_test21.h"
+
+rt_void o_test21()
+{
+    scene = new(&pfm) rt_Scene(&scn_test21::sc_root,
+                               x_res, y_res, x_row, RT_NULL, &pfm);
+}
+
+#endif /* SUB_TEST 21 */
+
 /******************************************************************************/
 /*********************************   TABLES   *********************************/
 /******************************************************************************/
@@ -553,8 +626,270 @@ testXX o_test[SUB_TEST] =
 #if SUB_TEST >= 18
     o_test18,
 #endif /* SUB_TEST 18 */
+
+#if SUB_TEST >= 19
+    o_test19,
+#endif /* SUB_TEST 19 */
+
+#if SUB_TEST >= 20
+    o_test20,
+#endif /* SUB_TEST 20 */
+
+#if SUB_TEST >= 21
+    o_test21,
+#endif /* SUB_TEST 21 */
 };
 
+/******************************************************************************/
+/********************************   BENCHMARK   *******************************/
+/******************************************************************************/
+
+#include "scn_bench.h"
+
+/*
+ * Run scaling benchmark on procedurally generated scenes with 10, 100, ...
+ * up to "b_mode" surfaces, varying lights, clip relations and reflections.
+ * Average per-phase times (usec) per frame are saved into dump/bench.csv.
+ */
+rt_void bench_run()
+{
+    static
+    rt_si32 cfg[][3] =
+    {
+        /* lights   clip %  refl % */
+        {   1,      0,      0   },
+        {   8,      0,      0   },
+        {   1,      50,     0   },
+        {   1,      0,      30  },
+    };
+
+    rt_File fl(RT_PATH_DUMP "bench.csv", "w+");
+    rt_File *f = &fl;
+
+    if (f->error() != 0)
+    {
+        if (!l_mode) RT_LOGI("Cannot open dump/bench.csv for writing\n");
+        return;
+    }
+
+    f->fprint("surfaces,lights,clip,refl,simd,threads,frames,"
+              "update05,update1,update2,update25,update3,"
+              "tiling,render,frame\n");
+
+    rt_si32 i, j, k, n, simd = (&pfm)->get_simd();
+    rt_si32 cfg_num = RT_ARR_SIZE(cfg);
+
+    for (n = 10; n <= b_mode; n *= 10)
+    {
+        for (i = 0; i < cfg_num; i++)
+        {
+            rt_SCENE *scn = scn_bench::build(sys_alloc, n,
+                                             cfg[i][0], cfg[i][1], cfg[i][2]);
+
+            scene = new(&pfm) rt_Scene(scn,
+                                       x_res, y_res, x_row, RT_NULL, &pfm);
+
+            scene->set_opts(RT_OPTS_FULL);
+
+            for (j = 0; j < r_test; j++)
+            {
+                scene->render(j * f_time);
+            }
+
+            f->fprint("%d,%d,%d,%d,%dx%dv%d,%d,%d", n,
+                cfg[i][0], cfg[i][1], cfg[i][2], (simd & 0xFF) * 128,
+                (simd >> 16) & 0xFF, (simd >> 8) & 0xFF,
+                (&pfm)->get_thnum(), r_test);
+
+            for (k = 0; k < RT_PROF_PHASES; k++)
+            {
+                rt_PROF *prf = scene->get_prof(k);
+
+                f->fprint(",%ld", (long)(prf->cnt ? prf->sum / prf->cnt : 0));
+            }
+
+            f->fprint("\n");
+
+            if (!l_mode)
+            RT_LOGI("Bench srf = %5d, lgt = %d, clp = %2d%%, rfl = %2d%%, "
+                    "frame = %ld usec\n", n, cfg[i][0], cfg[i][1], cfg[i][2],
+                    (long)(scene->get_prof(RT_PROF_FRAME)->cnt ?
+                           scene->get_prof(RT_PROF_FRAME)->sum /
+                           scene->get_prof(RT_PROF_FRAME)->cnt : 0));
+
+            delete scene;
+            scene = RT_NULL;
+
+            scn_bench::erase(sys_free);
+        }
+    }
+}
+
+/******************************************************************************/
+/*********************************   RESULTS   ********************************/
+/******************************************************************************/
+
+#define RT_REPS_MAX         15
+
+/*
+ * Render "r_test" consecutive frames "r_reps" times (continuing scene's time),
+ * return median time (ms) of the repeats to filter out system noise.
+ * In pipelined mode the next frame is updated while the previous one renders.
+ */
+rt_time time_run()
+{
+    rt_time t[RT_REPS_MAX], time;
+    rt_si32 j, k, n = 0;
+
+    for (k = 0; k < r_reps; k++)
+    {
+        time = get_time();
+
+        for (j = 0; j < r_test; j++, n++)
+        {
+            if (scene->get_pipe())
+            {
+                scene->prepare(q_test ? 0 : n * f_time);
+                scene->render_wait();
+                scene->render_post();
+            }
+            else
+            {
+                scene->render(q_test ? 0 : n * f_time);
+            }
+        }
+
+        /* finish the last pipelined frame */
+        scene->render_wait();
+
+        time = get_time() - time;
+
+        /* insertion sort */
+        for (j = k; j > 0 && t[j-1] > time; j--)
+        {
+            t[j] = t[j-1];
+        }
+
+        t[j] = time;
+    }
+
+    return t[r_reps / 2];
+}
+
+/*
+ * Save per-subtest times and target config into "j_file" in JSON format.
+ */
+rt_void json_save()
+{
+    rt_File fl(j_file, "w+");
+    rt_File *f = &fl;
+
+    if (f->error() != 0)
+    {
+        if (!l_mode) RT_LOGI("Cannot open %s for writing\n", j_file);
+        return;
+    }
+
+    rt_si32 i;
+
+    f->fprint("{\n");
+    f->fprint("    \"simd\": \"%dx%dv%d\",\n", n_simd * 128, k_size, s_type);
+    f->fprint("    \"threads\": %d,\n", (&pfm)->get_thnum());
+    f->fprint("    \"x_res\": %d,\n", x_res);
+    f->fprint("    \"y_res\": %d,\n", y_res);
+    f->fprint("    \"fsaa\": %d,\n", 1 << a_mode);
+    f->fprint("    \"frames\": %d,\n", r_test);
+    f->fprint("    \"repeats\": %d,\n", r_reps);
+    f->fprint("    \"tests\": [\n");
+
+    for (i = n_init; i <= n_done; i++)
+    {
+        f->fprint("        {\"test\": %d, \"time_n\": %ld, \"time_f\": %ld}%s\n",
+                  i+1, (long)t_runN[i], (long)t_runF[i], i < n_done ? "," : "");
+    }
+
+    f->fprint("    ]\n");
+    f->fprint("}\n");
+}
+
+/*
+ * Compare current per-subtest times against those saved in "c_file",
+ * flag slowdowns beyond "c_thrs" percent (and 1 ms), return their number.
+ */
+rt_si32 json_cmp()
+{
+    static
+    rt_char buf[65536], str[64];
+
+    rt_File fl(c_file, "rb");
+    rt_File *f = &fl;
+
+    if (f->error() != 0)
+    {
+        if (!l_mode) RT_LOGI("Cannot open %s for comparison\n", c_file);
+        return 0;
+    }
+
+    buf[f->load(buf, 1, sizeof(buf) - 1)] = '\0';
+
+    /* warn if results were taken with a different config */
+    sprintf(str, "\"simd\": \"%dx%dv%d\"", n_simd * 128, k_size, s_type);
+    rt_bool cfg = strstr(buf, str) != RT_NULL;
+    sprintf(str, "\"threads\": %d,", (&pfm)->get_thnum());
+    cfg = cfg && strstr(buf, str) != RT_NULL;
+    sprintf(str, "\"x_res\": %d,", x_res);
+    cfg = cfg && strstr(buf, str) != RT_NULL;
+    sprintf(str, "\"y_res\": %d,", y_res);
+    cfg = cfg && strstr(buf, str) != RT_NULL;
+
+    if (!cfg && !l_mode)
+    {
+        RT_LOGI("Target config differs from %s\n", c_file);
+    }
+
+    rt_si32 i, k, num = 0, ret = 0;
+    long tn, tf;
+    rt_char *p;
+
+    for (p = strstr(buf, "\"test\":"); p != RT_NULL;
+         p = strstr(p + 1, "\"test\":"))
+    {
+        if (sscanf(p, "\"test\": %d, \"time_n\": %ld, \"time_f\": %ld",
+                   &i, &tn, &tf) != 3 || i < n_init + 1 || i > n_done + 1)
+        {
+            continue;
+        }
+
+        i--;
+        num++;
+
+        for (k = 0; k < 2; k++)
+        {
+            rt_time t_old = k == 0 ? tn : tf;
+            rt_time t_new = k == 0 ? t_runN[i] : t_runF[i];
+
+            if (t_old <= 0 || t_new < 0
+            ||  t_new * 100 <= t_old * (100 + c_thrs) || t_new - t_old <= 1)
+            {
+                continue;
+            }
+
+            ret++;
+
+            if (!l_mode)
+            RT_LOGI("Slowdown in test %2d: Time %c = %ld -> %ld (+%ld%%)\n",
+                    i+1, k == 0 ? 'N' : 'F', (long)t_old, (long)t_new,
+                    (long)((t_new - t_old) * 100 / t_old));
+        }
+    }
+
+    if (!l_mode)
+    RT_LOGI("Compared %d subtests with %s, slowdowns above %d%%: %d\n",
+                                                num, c_file, c_thrs, ret);
+
+    return ret;
+}
+
 /******************************************************************************/
 /**********************************   MAIN   **********************************/
 /******************************************************************************/
@@ -595,6 +930,15 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
         RT_LOGI(" -l, enable log-off mode, no printing to file and screen\n");
         RT_LOGI(" -o, enable optimal mode, omit unoptimized rendering run\n");
         RT_LOGI(" -q, enable quality mode, activate path-tracing lighting\n");
+        RT_LOGI(" -P, enable profile mode, save phase-timings into dump/\n");
+        RT_LOGI(" -u n, enable autotune mode, n frames per SIMD target\n");
+        RT_LOGI(" -B n, run scaling benchmark upto n surfaces into dump/\n");
+        RT_LOGI(" -r n, repeat timed runs n times, report median, n <= 15\n");
+        RT_LOGI(" --json [file], save timings (dump/rslt.json by default)\n");
+        RT_LOGI(" --cmp file, compare timings with results saved by --json\n");
+        RT_LOGI(" --thr n, override slowdown threshold (%%) for --cmp, 10\n");
+        RT_LOGI(" --trace n, save n-event trace rings per subtest to dump/\n");
+        RT_LOGI(" --pipe, check pipelined run against frames of serial run\n");
         RT_LOGI(" -a, enable 4x antialiasing by default, 8x not supported\n");
         RT_LOGI(" -a n, enable antialiasing, 2 for 2x, 4 for 4x, 8 for 8x\n");
         RT_LOGI(" -t tex1 tex2 texn, convert images in data/textures/tex*\n");
@@ -881,6 +1225,119 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
             q_mode = RT_TRUE;
             if (!l_mode) RT_LOGI("Quality mode enabled: %d\n", q_mode);
         }
+        if (k < argc && strcmp(argv[k], "-P") == 0 && !m_mode)
+        {
+            m_mode = RT_TRUE;
+            if (!l_mode) RT_LOGI("Profile mode enabled: %d\n", m_mode);
+        }
+        if (k < argc && strcmp(argv[k], "-B") == 0 && ++k < argc)
+        {
+            for (l = strlen(argv[k]), r = 1, t = 0; l > 0; l--, r *= 10)
+            {
+                t += (argv[k][l-1] - '0') * r;
+            }
+            if (t >= 10)
+            {
+                if (!l_mode) RT_LOGI("Benchmark mode enabled: %d\n", t);
+                b_mode = t;
+            }
+            else
+            {
+                if (!l_mode) RT_LOGI("Benchmark surfaces value out of range\n");
+                return 0;
+            }
+        }
+        if (k < argc && strcmp(argv[k], "-r") == 0 && ++k < argc)
+        {
+            for (l = strlen(argv[k]), r = 1, t = 0; l > 0; l--, r *= 10)
+            {
+                t += (argv[k][l-1] - '0') * r;
+            }
+            if (t >= 1 && t <= RT_REPS_MAX)
+            {
+                if (!l_mode) RT_LOGI("Median-of-N repeats: %d\n", t);
+                r_reps = t;
+            }
+            else
+            {
+                if (!l_mode) RT_LOGI("Median-of-N repeats out of range\n");
+                return 0;
+            }
+        }
+        if (k < argc && strcmp(argv[k], "--json") == 0)
+        {
+            j_file = RT_PATH_DUMP "rslt.json";
+            if (++k < argc && argv[k][0] != '-')
+            {
+                j_file = argv[k];
+            }
+            else
+            {
+                k--;
+            }
+            if (!l_mode) RT_LOGI("JSON results file: %s\n", j_file);
+        }
+        if (k < argc && strcmp(argv[k], "--cmp") == 0 && ++k < argc)
+        {
+            c_file = argv[k];
+            if (!l_mode) RT_LOGI("JSON compare file: %s\n", c_file);
+        }
+        if (k < argc && strcmp(argv[k], "--thr") == 0 && ++k < argc)
+        {
+            for (l = strlen(argv[k]), r = 1, t = 0; l > 0; l--, r *= 10)
+            {
+                t += (argv[k][l-1] - '0') * r;
+            }
+            if (t >= 0 && t <= 1000)
+            {
+                if (!l_mode) RT_LOGI("Slowdown threshold overridden: %d\n", t);
+                c_thrs = t;
+            }
+            else
+            {
+                if (!l_mode) RT_LOGI("Slowdown threshold value out of range\n");
+                return 0;
+            }
+        }
+        if (k < argc && strcmp(argv[k], "--trace") == 0 && ++k < argc)
+        {
+            for (l = strlen(argv[k]), r = 1, t = 0; l > 0; l--, r *= 10)
+            {
+                t += (argv[k][l-1] - '0') * r;
+            }
+            if (t >= 1 && t <= 10000000)
+            {
+                if (!l_mode) RT_LOGI("Trace-ring size: %d\n", t);
+                j_ring = t;
+            }
+            else
+            {
+                if (!l_mode) RT_LOGI("Trace-ring size value out of range\n");
+                return 0;
+            }
+        }
+        if (k < argc && strcmp(argv[k], "--pipe") == 0 && !y_pipe)
+        {
+            y_pipe = RT_TRUE;
+            if (!l_mode) RT_LOGI("Pipeline mode enabled: %d\n", y_pipe);
+        }
+        if (k < argc && strcmp(argv[k], "-u") == 0 && ++k < argc)
+        {
+            for (l = strlen(argv[k]), r = 1, t = 0; l > 0; l--, r *= 10)
+            {
+                t += (argv[k][l-1] - '0') * r;
+            }
+            if (t >= 1)
+            {
+                if (!l_mode) RT_LOGI("Autotune mode enabled: %d\n", t);
+                u_mode = t;
+            }
+            else
+            {
+                if (!l_mode) RT_LOGI("Autotune frames value out of range\n");
+                return 0;
+            }
+        }
         if (k < argc && strcmp(argv[k], "-a") == 0)
         {
             rt_si32 aa_map[10] =
@@ -916,10 +1373,9 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
     }
     r_test = RT_ABS32(r_test);
 
-    rt_time time1 = 0;
-    rt_time time2 = 0;
     rt_time tN = 0;
     rt_time tF = 0;
+    rt_time tP = 0;
 
     x_res = x_res * (w_size != 0 ? w_size : 1);
     y_res = y_res * (w_size != 0 ? w_size : 1);
@@ -937,6 +1393,8 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
     }
     tile_w = (&pfm)->get_tile_w();
 
+    (&pfm)->set_trace(j_ring);
+
     size = (simd >> 16) & 0xFF;
     type = (simd >> 8) & 0xFF;
     simd = simd & 0xFF;
@@ -958,6 +1416,11 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
 
     frame = (rt_ui32 *)sys_alloc(x_row * y_res * sizeof(rt_ui32));
 
+    if (y_pipe)
+    {
+        pframe = (rt_ui32 *)sys_alloc(x_row * y_res * sizeof(rt_ui32));
+    }
+
     if (!l_mode)
     {
         RT_LOGI("------------------  TARGET CONFIG  ---------------------\n");
@@ -971,10 +1434,28 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
                     o_mode ? "o" : q_mode ? "p" : " ",  q_mode ? "q" : " ");
     }
 
-    rt_si32 i, j;
+    if (b_mode)
+    {
+        try
+        {
+            bench_run();
+        }
+        catch (rt_Exception e)
+        {
+            if (!l_mode) RT_LOGE("Exception in benchmark: %s\n", e.err);
+        }
+
+        /* skip subtests in benchmark mode */
+        n_done = n_init - 1;
+    }
+
+    rt_si32 i, ret = 0;
 
     for (i = n_init; i <= n_done; i++)
     {
+        t_runN[i] = -1;
+        t_runF[i] = -1;
+
         if (!l_mode)
         RT_LOGI("--------------------  SUB TEST = %2d  - ptr/fp = %d%s%d --\n",
                     i+1, RT_POINTER, RT_ADDRESS == 32 ? "_" : "f", RT_ELEMENT);
@@ -993,15 +1474,13 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
             scene->set_opts(RT_OPTS_NONE);
             q_test = scene->set_pton(q_mode);
 
-            time1 = get_time();
-
-            for (j = 0; j < r_test; j++)
+            if (u_mode)
             {
-                scene->render(q_test ? 0 : j * f_time);
+                tune_run();
             }
 
-            time2 = get_time();
-            tN = time2 - time1;
+            tN = time_run();
+            t_runN[i] = tN;
             if (!l_mode) RT_LOGI("Time N = %d\n", (rt_si32)tN);
 
             if (h_mode)
@@ -1019,6 +1498,11 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
                 scene->save_frame((i+1) * 10 + 0 + RT_MAX(0, -i_mode*1000));
             }
 
+            if (m_mode)
+            {
+                scene->save_prof((i+1) * 10 + 0);
+            }
+
             frame_cpy(frame, scene->get_frame());
 
             delete scene;
@@ -1033,15 +1517,13 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
             scene->set_opts(RT_OPTS_FULL);
             q_test = scene->set_pton(q_mode);
 
-            time1 = get_time();
-
-            for (j = 0; j < r_test; j++)
+            if (u_mode)
             {
-                scene->render(q_test ? 0 : j * f_time);
+                tune_run();
             }
 
-            time2 = get_time();
-            tF = time2 - time1;
+            tF = time_run();
+            t_runF[i] = tF;
             if (!l_mode) RT_LOGI("Time F = %d\n", (rt_si32)tF);
 
             if (h_mode)
@@ -1059,6 +1541,21 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
                 scene->save_frame((i+1) * 10 + 1 + RT_MAX(0, -i_mode*1000));
             }
 
+            if (m_mode)
+            {
+                scene->save_prof((i+1) * 10 + 1);
+            }
+
+            if (j_ring)
+            {
+                (&pfm)->save_trace((i+1) * 10 + 1);
+            }
+
+            if (y_pipe)
+            {
+                frame_cpy(pframe, scene->get_frame());
+            }
+
             if (!o_mode)
             { /* -->---->-- skip diff -->---->-- */
 
@@ -1082,6 +1579,52 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
 
             delete scene;
             scene = RT_NULL;
+
+            if (y_pipe)
+            { /* -->---->-- skip pipe -->---->-- */
+
+            /* ------------ test pipe ---------- */
+
+            o_test[i]();
+
+            scene->set_opts(RT_OPTS_FULL);
+            q_test = scene->set_pton(q_mode);
+            scene->set_pipe(1);
+
+            if (u_mode)
+            {
+                tune_run();
+            }
+
+            tP = time_run();
+            if (!l_mode) RT_LOGI("Time P = %d\n", (rt_si32)tP);
+
+            if (i_mode)
+            {
+                scene->save_frame((i+1) * 10 + 4 + RT_MAX(0, -i_mode*1000));
+            }
+
+            if (m_mode)
+            {
+                scene->save_prof((i+1) * 10 + 4);
+            }
+
+            /* pipelined frames are to match serial ones exactly,
+             * including isolated pixels */
+            rt_si32 diff = t_diff;
+            rt_bool hunt = p_mode;
+            t_diff = 0;
+            p_mode = RT_TRUE;
+
+            ret |= frame_cmp(pframe, scene->get_frame());
+
+            t_diff = diff;
+            p_mode = hunt;
+
+            delete scene;
+            scene = RT_NULL;
+
+            } /* --<----<-- skip pipe --<----<-- */
         }
         catch (rt_Exception e)
         {
@@ -1095,6 +1638,21 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
 
     sys_free(frame, x_row * y_res * sizeof(rt_ui32));
 
+    if (y_pipe)
+    {
+        sys_free(pframe, x_row * y_res * sizeof(rt_ui32));
+    }
+
+    if (j_file != RT_NULL && !b_mode)
+    {
+        json_save();
+    }
+
+    if (c_file != RT_NULL && !b_mode)
+    {
+        ret |= json_cmp() > 0;
+    }
+
 #if (defined RT_WIN32) || (defined RT_WIN64) /* Win32, MSVC -- Win64, GCC --- */
 
     if (!l_mode)
@@ -1104,7 +1662,7 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
 
 #endif /* ------------- OS specific ----------------------------------------- */
 
-    return 0;
+    return ret;
 }
 
 /******************************************************************************/
@@ -0,0 +1,209 @@
+/******************************************************************************/
+/* Copyright (c) 2013-2025 VectorChief (at github, bitbucket, sourceforge)    */
+/* Distributed under the MIT software license, see the accompanying           */
+/* file COPYING or http://www.opensource.org/licenses/mit-license.php         */
+/******************************************************************************/
+
+#ifndef RT_SCN_BENCH_H
+#define RT_SCN_BENCH_H
+
+#include "format.h"
+
+#include "all_mat.h"
+#include "all_obj.h"
+
+/*
+ * Procedurally generated scene for scaling benchmarks (see core_test -B).
+ * Surfaces are spheres grouped into sub-arrays of RT_BENCH_GROUP elements,
+ * sub-arrays are laid out on a square grid above the floor plane,
+ * lights are spread evenly over the grid at a fixed height.
+ * Scene density is controlled by the percentage of surfaces clipped
+ * by their neighbour (clip relations) and the percentage of reflective ones.
+ */
+#define RT_BENCH_GROUP      8 /* surfaces per sub-array (4 x 2) */
+#define RT_BENCH_STEP       4.0f /* distance between sub-arrays */
+
+namespace scn_bench
+{
+
+/******************************************************************************/
+/**********************************   BASE   **********************************/
+/******************************************************************************/
+
+rt_PLANE pl_floor01 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {  -RT_INF,    -RT_INF,    -RT_INF  },
+/* max */   {  +RT_INF,    +RT_INF,    +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray02,
+        },
+    },
+};
+
+/******************************************************************************/
+/*******************************   GENERATOR   ********************************/
+/******************************************************************************/
+
+rt_OBJECT  *ob_tree     = RT_NULL;  /* root array */
+rt_OBJECT  *ob_items    = RT_NULL;  /* all sub-arrays' elements */
+rt_RELATION*rl_items    = RT_NULL;  /* all sub-arrays' clip relations */
+rt_si32     ob_size     = 0;        /* allocated size in bytes */
+
+rt_SCENE sc_root;
+
+/*
+ * Fill object entry with given transform and object data.
+ */
+rt_void set_obj(rt_OBJECT *obj, rt_real x, rt_real y, rt_real z,
+                rt_real rot, rt_real scl, rt_si32 tag, rt_pntr pobj,
+                rt_si32 obj_num, rt_RELATION *prel, rt_si32 rel_num,
+                rt_MATERIAL *pmat)
+{
+    memset(obj, 0, sizeof(rt_OBJECT));
+
+    obj->trm.scl[RT_X] = scl;
+    obj->trm.scl[RT_Y] = scl;
+    obj->trm.scl[RT_Z] = scl;
+
+    obj->trm.rot[RT_X] = rot;
+
+    obj->trm.pos[RT_X] = x;
+    obj->trm.pos[RT_Y] = y;
+    obj->trm.pos[RT_Z] = z;
+
+    obj->obj.tag = tag;
+    obj->obj.pobj = pobj;
+    obj->obj.obj_num = obj_num;
+    obj->obj.prel = prel;
+    obj->obj.rel_num = rel_num;
+    obj->obj.pmat_outer = pmat;
+    obj->obj.pmat_inner = pmat;
+}
+
+/*
+ * Build scene with "srf_num" spheres, "lgt_num" lights,
+ * "rel_pct" percent of spheres clipped by their neighbour
+ * and "rfl_pct" percent of reflective spheres.
+ * Memory is taken from "f_alloc", previous scene must be erased first.
+ */
+rt_SCENE *build(rt_FUNC_ALLOC f_alloc, rt_si32 srf_num, rt_si32 lgt_num,
+                rt_si32 rel_pct, rt_si32 rfl_pct)
+{
+    rt_si32 grp_num = (srf_num + RT_BENCH_GROUP - 1) / RT_BENCH_GROUP;
+    rt_si32 row_num = 1, i, j, k, n, r;
+
+    while (row_num * row_num < grp_num)
+    {
+        row_num++;
+    }
+
+    /* floor, camera, lights and sub-arrays in the root array */
+    rt_si32 tree_num = 2 + lgt_num + grp_num;
+
+    ob_size = (tree_num + srf_num) * sizeof(rt_OBJECT) +
+              srf_num * sizeof(rt_RELATION);
+
+    ob_tree = (rt_OBJECT *)f_alloc(ob_size);
+    ob_items = ob_tree + tree_num;
+    rl_items = (rt_RELATION *)(ob_items + srf_num);
+
+    rt_real ext = row_num * RT_BENCH_STEP * 0.5f;
+
+    set_obj(&ob_tree[0], 0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+            RT_TAG_PLANE, &pl_floor01, 1, RT_NULL, 0, RT_NULL);
+
+    /* camera looks 45 degrees down at the grid's center */
+    set_obj(&ob_tree[1], 0.0f, -ext * 1.5f, ext * 1.5f, -135.0f, 1.0f,
+            RT_TAG_CAMERA, &cm_camera01, 1, RT_NULL, 0, RT_NULL);
+
+    for (i = 0; i < lgt_num; i++)
+    {
+        set_obj(&ob_tree[2 + i],
+                ext * (2.0f * (i % 3) - 2.0f) * 0.5f,
+                ext * (2.0f * (i / 3 % 3) - 2.0f) * 0.5f,
+                4.0f + (i / 9), 0.0f, 1.0f,
+                RT_TAG_LIGHT, &lt_light01, 1, RT_NULL, 0, RT_NULL);
+    }
+
+    for (i = 0, k = 0, r = 0; i < grp_num; i++)
+    {
+        rt_OBJECT *grp = &ob_items[k];
+        rt_RELATION *rel = &rl_items[r];
+
+        n = RT_MIN(RT_BENCH_GROUP, srf_num - k);
+
+        for (j = 0; j < n; j++, k++)
+        {
+            /* spread clipped and reflective spheres evenly */
+            rt_MATERIAL *pmat = (k * 37) % 100 < rfl_pct ?
+                                &mt_metal01_cyan01 : RT_NULL;
+
+            set_obj(&grp[j], (j % 4) * 0.75f - 1.125f,
+                             (j / 4) * 0.75f - 0.375f, 0.5f, 0.0f, 0.3f,
+                    RT_TAG_SPHERE, &sp_ball01, 1, RT_NULL, 0, pmat);
+
+            if (j + 1 < n && (k * 53) % 100 < rel_pct)
+            {
+                rl_items[r].obj1 = j;
+                rl_items[r].rel  = RT_REL_MINUS_OUTER;
+                rl_items[r].obj2 = j + 1;
+                r++;
+            }
+        }
+
+        set_obj(&ob_tree[2 + lgt_num + i],
+                ((i % row_num) + 0.5f) * RT_BENCH_STEP - ext,
+                ((i / row_num) + 0.5f) * RT_BENCH_STEP - ext, 0.0f, 0.0f,
+                1.0f, RT_TAG_ARRAY, grp, n, rel, (rt_si32)(&rl_items[r] - rel),
+                RT_NULL);
+    }
+
+    memset(&sc_root, 0, sizeof(rt_SCENE));
+
+    sc_root.root.tag = RT_TAG_ARRAY;
+    sc_root.root.pobj = ob_tree;
+    sc_root.root.obj_num = tree_num;
+    /* list of optimizations to be turned off *
+     * refer to core/engine/format.h for defs */
+    sc_root.opts = RT_OPTS_PT;
+
+    return &sc_root;
+}
+
+/*
+ * Release memory of the scene built last (to "f_free").
+ */
+rt_void erase(rt_FUNC_FREE f_free)
+{
+    if (ob_tree != RT_NULL)
+    {
+        f_free(ob_tree, ob_size);
+    }
+
+    ob_tree = RT_NULL;
+    ob_items = RT_NULL;
+    rl_items = RT_NULL;
+    ob_size = 0;
+}
+
+} /* namespace scn_bench */
+
+#endif /* RT_SCN_BENCH_H */
+
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
@@ -0,0 +1,258 @@
+/******************************************************************************/
+/* Copyright (c) 2013-2025 VectorChief (at github, bitbucket, sourceforge)    */
+/* Distributed under the MIT software license, see the accompanying           */
+/* file COPYING or http://www.opensource.org/licenses/mit-license.php         */
+/******************************************************************************/
+
+#ifndef RT_SCN_TEST19_H
+#define RT_SCN_TEST19_H
+
+#include "format.h"
+
+#include "all_mat.h"
+#include "all_obj.h"
+
+namespace scn_test19
+{
+
+/******************************************************************************/
+/**********************************   BASE   **********************************/
+/******************************************************************************/
+
+rt_PLANE pl_floor01 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {   -9.0,       -5.0,      -RT_INF  },
+/* max */   {   +9.0,       +5.0,      +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray02,
+        },
+    },
+};
+
+rt_DISTFIELD df_menger01 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {  -RT_INF,    -RT_INF,    -RT_INF  },
+/* max */   {  +RT_INF,    +RT_INF,    +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_orange01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray02,
+        },
+    },
+/* sdf */   RT_SDF_MENGER,
+/* box */   {    1.5,        1.5,        1.5    },
+/* rnd */   0.0,
+/* rad */   0.0,
+/* bld */   0.0,
+/* itr */   3,
+/* stp */   0,
+/* eps */   0.0,
+};
+
+rt_DISTFIELD df_blend01 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {  -RT_INF,    -RT_INF,    -RT_INF  },
+/* max */   {  +RT_INF,    +RT_INF,    +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_metal01_cyan01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray02,
+        },
+    },
+/* sdf */   RT_SDF_UNION,
+/* box */   {    1.0,        1.0,        0.5    },
+/* rnd */   0.1,
+/* rad */   1.0,
+/* bld */   0.5,
+/* itr */   0,
+/* stp */   0,
+/* eps */   0.0,
+};
+
+rt_DISTFIELD df_carve01 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {  -RT_INF,    -RT_INF,    -RT_INF  },
+/* max */   {  +RT_INF,    +RT_INF,    +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_pink01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray02,
+        },
+    },
+/* sdf */   RT_SDF_SUBTRACT,
+/* box */   {    1.2,        1.2,        1.2    },
+/* rnd */   0.2,
+/* rad */   1.5,
+/* bld */   0.2,
+/* itr */   0,
+/* stp */   0,
+/* eps */   0.0,
+};
+
+/******************************************************************************/
+/*********************************   CAMERA   *********************************/
+/******************************************************************************/
+
+rt_OBJECT ob_camera01[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   { -105.0,        0.0,        0.0    },
+/* pos */   {    0.0,      -12.0,        0.0    },
+        },
+        RT_OBJ_CAMERA(&cm_camera01)
+    },
+};
+
+/******************************************************************************/
+/*********************************   LIGHTS   *********************************/
+/******************************************************************************/
+
+rt_OBJECT ob_light01[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_LIGHT(&lt_light01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_SPHERE(&sp_bulb01)
+    },
+};
+
+/******************************************************************************/
+/**********************************   TREE   **********************************/
+/******************************************************************************/
+
+rt_OBJECT ob_tree[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_PLANE(&pl_floor01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,       30.0    },
+/* pos */   {   -4.0,        0.0,        1.5    },
+        },
+        RT_OBJ_DISTFIELD(&df_menger01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        1.5    },
+        },
+        RT_OBJ_DISTFIELD(&df_blend01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,      -30.0    },
+/* pos */   {   +4.0,        0.0,        1.2    },
+        },
+        RT_OBJ_DISTFIELD(&df_carve01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,       -2.8,        4.3    },
+        },
+        RT_OBJ_ARRAY(&ob_light01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,       -4.0,        5.0    },
+        },
+        RT_OBJ_ARRAY(&ob_camera01)
+    },
+};
+
+/******************************************************************************/
+/**********************************   SCENE   *********************************/
+/******************************************************************************/
+
+rt_SCENE sc_root =
+{
+    RT_OBJ_ARRAY(&ob_tree),
+    /* list of optimizations to be turned off *
+     * refer to core/engine/format.h for defs */
+    RT_OPTS_PT
+    /* turning off GAMMA|FRESNEL opts in turn *
+     * enables respective GAMMA|FRESNEL props */
+};
+
+} /* namespace scn_test19 */
+
+#endif /* RT_SCN_TEST19_H */
+
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
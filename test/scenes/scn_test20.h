@@ -0,0 +1,273 @@
+/******************************************************************************/
+/* Copyright (c) 2013-2025 VectorChief (at github, bitbucket, sourceforge)    */
+/* Distributed under the MIT software license, see the accompanying           */
+/* file COPYING or http://www.opensource.org/licenses/mit-license.php         */
+/******************************************************************************/
+
+#ifndef RT_SCN_TEST20_H
+#define RT_SCN_TEST20_H
+
+#include "format.h"
+
+#include "all_mat.h"
+#include "all_obj.h"
+
+namespace scn_test20
+{
+
+/******************************************************************************/
+/**********************************   BASE   **********************************/
+/******************************************************************************/
+
+rt_PLANE pl_floor01 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {   -9.0,       -6.0,      -RT_INF  },
+/* max */   {   +9.0,       +6.0,      +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray02,
+        },
+    },
+};
+
+/******************************************************************************/
+/*********************************   CAMERA   *********************************/
+/******************************************************************************/
+
+rt_OBJECT ob_camera01[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   { -105.0,        0.0,        0.0    },
+/* pos */   {    0.0,      -12.0,        0.0    },
+        },
+        RT_OBJ_CAMERA(&cm_camera01)
+    },
+};
+
+/******************************************************************************/
+/*********************************   LIGHTS   *********************************/
+/******************************************************************************/
+
+rt_LIGHT lt_sphere01 =
+{
+    RT_LGT(SPHERE),
+
+    RT_COL(0xFFFFFFFF),
+
+    {/* amb     src */
+        0.01,   1.2
+    },
+    {/* rng     cnt     lnr     qdr */
+        0.0,    0.7,    0.5,    0.1
+    },
+    {/* rad */
+        0.5,    0.0
+    },
+};
+
+rt_SPHERE sp_bulb02 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {  -RT_INF,    -RT_INF,    -RT_INF  },
+/* max */   {  +RT_INF,    +RT_INF,    +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_light01_bulb01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_light01_bulb01,
+        },
+    },
+/* rad */   0.5,
+};
+
+rt_LIGHT lt_rect01 =
+{
+    RT_LGT(RECT),
+
+    RT_COL(0xFFFFE0C0),
+
+    {/* amb     src */
+        0.0,    1.0
+    },
+    {/* rng     cnt     lnr     qdr */
+        0.0,    0.7,    0.5,    0.1
+    },
+    {/* hsu     hsv */
+        1.5,    0.5
+    },
+};
+
+rt_PLANE pl_panel01 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {   -1.5,       -0.5,      -RT_INF  },
+/* max */   {   +1.5,       +0.5,      +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_light01_bulb01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_light01_bulb01,
+        },
+    },
+};
+
+rt_OBJECT ob_light01[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_LIGHT(&lt_sphere01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_SPHERE(&sp_bulb02)
+    },
+};
+
+rt_OBJECT ob_light02[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_LIGHT(&lt_rect01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_PLANE(&pl_panel01)
+    },
+};
+
+/******************************************************************************/
+/**********************************   TREE   **********************************/
+/******************************************************************************/
+
+rt_OBJECT ob_tree[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_PLANE(&pl_floor01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    0.7,        0.7,        0.7    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {   -3.5,        0.0,        1.05   },
+        },
+        RT_OBJ_SPHERE(&sp_ball01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    0.5,        0.5,        1.5    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        1.0,        2.25   },
+        },
+        RT_OBJ_SPHERE(&sp_ball01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    0.7,        0.7,        0.7    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {   +3.5,        0.0,        1.05   },
+        },
+        RT_OBJ_SPHERE(&sp_ball01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {   -2.0,       -2.0,        5.0    },
+        },
+        RT_OBJ_ARRAY(&ob_light01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {   +2.5,        0.0,        6.0    },
+        },
+        RT_OBJ_ARRAY(&ob_light02)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,       -4.0,        5.0    },
+        },
+        RT_OBJ_ARRAY(&ob_camera01)
+    },
+};
+
+/******************************************************************************/
+/**********************************   SCENE   *********************************/
+/******************************************************************************/
+
+rt_SCENE sc_root =
+{
+    RT_OBJ_ARRAY(&ob_tree),
+    /* list of optimizations to be turned off *
+     * refer to core/engine/format.h for defs */
+    RT_OPTS_PT
+    /* turning off GAMMA|FRESNEL opts in turn *
+     * enables respective GAMMA|FRESNEL props */
+};
+
+} /* namespace scn_test20 */
+
+#endif /* RT_SCN_TEST20_H */
+
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
@@ -0,0 +1,256 @@
+/******************************************************************************/
+/* Copyright (c) 2013-2025 VectorChief (at github, bitbucket, sourceforge)    */
+/* Distributed under the MIT software license, see the accompanying           */
+/* file COPYING or http://www.opensource.org/licenses/mit-license.php         */
+/******************************************************************************/
+
+#ifndef RT_SCN_TEST21_H
+#define RT_SCN_TEST21_H
+
+#include "format.h"
+
+#include "all_mat.h"
+#include "all_obj.h"
+
+namespace scn_test21
+{
+
+/******************************************************************************/
+/**********************************   BASE   **********************************/
+/******************************************************************************/
+
+rt_PLANE pl_floor01 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {  -20.0,      -10.0,      -RT_INF  },
+/* max */   {  +20.0,     +160.0,      +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_plain01_gray02,
+        },
+    },
+};
+
+rt_OBJECT ob_detail01[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_SPHERE(&sp_ball01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    0.5,        0.5,        0.5    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_SPHERE(&sp_ball01)
+    },
+};
+
+rt_OBJECT ob_lod01[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_ARRAY(&ob_detail01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_SPHERE(&sp_ball01)
+    },
+};
+
+/* inner sphere of the detailed array is enclosed by the outer one,
+ * so the alternate renders the same image at every distance */
+rt_RELATION rl_lod01[] =
+{
+    {   0,  RT_REL_LOD_ARRAY,     1   },
+};
+
+/* move back and forth along the view direction (absolute time),
+ * so that level-of-detail is switched off and back on during the run */
+rt_void an_lod01(rt_time time, rt_time last_time,
+                 rt_TRANSFORM3D *trm, rt_pntr pobj)
+{
+    rt_time t = time % 2048;
+
+    t = t < 1024 ? t : 2048 - t;
+
+    trm->pos[RT_Y] = t * (150.0f / 1024.0f);
+}
+
+/******************************************************************************/
+/*********************************   CAMERA   *********************************/
+/******************************************************************************/
+
+rt_OBJECT ob_camera01[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   { -105.0,        0.0,        0.0    },
+/* pos */   {    0.0,      -12.0,        0.0    },
+        },
+        RT_OBJ_CAMERA(&cm_camera01)
+    },
+};
+
+/******************************************************************************/
+/*********************************   LIGHTS   *********************************/
+/******************************************************************************/
+
+rt_LIGHT lt_sphere01 =
+{
+    RT_LGT(SPHERE),
+
+    RT_COL(0xFFFFFFFF),
+
+    {/* amb     src */
+        0.01,   1.2
+    },
+    {/* rng     cnt     lnr     qdr */
+        0.0,    0.7,    0.5,    0.1
+    },
+    {/* rad */
+        0.5,    0.0
+    },
+};
+
+rt_SPHERE sp_bulb02 =
+{
+    {      /*   RT_I,       RT_J,       RT_K    */
+/* min */   {  -RT_INF,    -RT_INF,    -RT_INF  },
+/* max */   {  +RT_INF,    +RT_INF,    +RT_INF  },
+        {
+/* OUTER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_light01_bulb01,
+        },
+        {
+/* INNER        RT_U,       RT_V    */
+/* scl */   {    1.0,        1.0    },
+/* rot */              0.0           ,
+/* pos */   {    0.0,        0.0    },
+
+/* mat */   &mt_light01_bulb01,
+        },
+    },
+/* rad */   0.5,
+};
+
+rt_OBJECT ob_light01[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_LIGHT(&lt_sphere01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_SPHERE(&sp_bulb02)
+    },
+};
+
+/******************************************************************************/
+/**********************************   TREE   **********************************/
+/******************************************************************************/
+
+rt_OBJECT ob_tree[] =
+{
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,        0.0,        0.0    },
+        },
+        RT_OBJ_PLANE(&pl_floor01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    0.7,        0.7,        0.7    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {   -3.5,        0.0,        1.05   },
+        },
+        RT_OBJ_SPHERE(&sp_ball01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {   +1.0,        0.0,        1.5    },
+        },
+        RT_OBJ_ARRAY_REL(&ob_lod01, &rl_lod01),
+        &an_lod01,
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {   -2.0,       -2.0,        5.0    },
+        },
+        RT_OBJ_ARRAY(&ob_light01)
+    },
+    {
+        {  /*   RT_X,       RT_Y,       RT_Z    */
+/* scl */   {    1.0,        1.0,        1.0    },
+/* rot */   {    0.0,        0.0,        0.0    },
+/* pos */   {    0.0,       -4.0,        5.0    },
+        },
+        RT_OBJ_ARRAY(&ob_camera01)
+    },
+};
+
+/******************************************************************************/
+/**********************************   SCENE   *********************************/
+/******************************************************************************/
+
+rt_SCENE sc_root =
+{
+    RT_OBJ_ARRAY(&ob_tree),
+    /* list of optimizations to be turned off *
+     * refer to core/engine/format.h for defs */
+    RT_OPTS_PT
+    /* turning off GAMMA|FRESNEL opts in turn *
+     * enables respective GAMMA|FRESNEL props */
+};
+
+} /* namespace scn_test21 */
+
+#endif /* RT_SCN_TEST21_H */
+
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
@@ -232,6 +232,7 @@ simd_test.x64f64avx512:
 # sde64 -hsw -- ./simd_test.x64f32avx -c 1
 # sde64 -skx -- ./simd_test.x64f32avx512 -c 1
 # Use "-c 1" option to reduce test time when emulating with Intel SDE
+# Use "-t 100" option to print ns/op table of instruction throughputs instead
 
 # Clang native build works too (takes much longer prior to 3.8), use (replace):
 # clang++ (in place of g++)
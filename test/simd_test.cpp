@@ -128,6 +128,7 @@ rt_si32     n_done      = SUB_TEST-1;   /* subtest-done (from command-line) */
 rt_si32     t_diff      = 2;          /* diff-threshold (from command-line) */
 rt_si32     r_test      = CYC_SIZE;   /* test-redundant (from command-line) */
 rt_bool     v_mode      = RT_FALSE;     /* verbose mode (from command-line) */
+rt_si32     b_time      = 0;          /* benchmark-time (from command-line) */
 
 /*
  * Get system time in milliseconds.
@@ -8291,6 +8292,701 @@ testXX p_test[SUB_TEST] =
 #endif /* SUB_TEST 51 */
 };
 
+/******************************************************************************/
+/*******************************   BENCHMARK   ********************************/
+/******************************************************************************/
+
+/*
+ * Throughput mode (-t n) times instruction families in tight ASM loops
+ * instead of validating them, results are reported in ns per SIMD op.
+ * Latency kernels (l_benchNN) run a single dependency chain of ops,
+ * throughput kernels (t_benchNN) issue independent ops from constant sources.
+ * As each SIMD target is built into a separate binary, compare the tables
+ * from different binaries to choose between rtarch_* variants for given CPU.
+ */
+
+#define BENCH_REPT          16 /* ops per loop iteration (4 bodies of 4) */
+
+/*
+ * Load initial values from the float array into Xmm0-Xmm5,
+ * constant +1.0 into Xmm6, Xmm7 and number of loop cycles into Redi.
+ */
+#define BENCH_INIT()                                                        \
+        movxx_ld(Recx, Mebp, inf_FAR0)                                      \
+        movpx_ld(Xmm0, Mecx, AJ0)                                           \
+        movpx_ld(Xmm1, Mecx, AJ1)                                           \
+        movpx_ld(Xmm2, Mecx, AJ2)                                           \
+        movpx_ld(Xmm3, Mecx, AJ0)                                           \
+        movpx_ld(Xmm4, Mecx, AJ1)                                           \
+        movpx_ld(Xmm5, Mecx, AJ2)                                           \
+        movpx_ld(Xmm6, Mebp, inf_GPC01)                                     \
+        movpx_ld(Xmm7, Mebp, inf_GPC01)                                     \
+        movwx_ld(Redi, Mebp, inf_CYC)
+
+/*
+ * Repeat given 4-op body to amortize the loop overhead.
+ */
+#define BENCH_BODY(body)                                                    \
+        body body body body
+
+/*
+ * Decrement the number of loop cycles in Redi, jump to "lb" if not done.
+ */
+#define BENCH_LOOP(lb)                                                      \
+        subwx_ri(Redi, IB(1))                                               \
+        cmjwx_ri(Redi, IB(0),                                               \
+        /* if */ GT_x, lb)
+
+/******************************   fp arithmetic   *****************************/
+
+rt_void l_bench01(rt_SIMD_INFOX *info) /* add latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        addps_rr(Xmm0, Xmm6)
+        addps_rr(Xmm0, Xmm6)
+        addps_rr(Xmm0, Xmm6)
+        addps_rr(Xmm0, Xmm6))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench01(rt_SIMD_INFOX *info) /* add throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        addps3rr(Xmm0, Xmm6, Xmm7)
+        addps3rr(Xmm1, Xmm6, Xmm7)
+        addps3rr(Xmm2, Xmm6, Xmm7)
+        addps3rr(Xmm3, Xmm6, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void l_bench02(rt_SIMD_INFOX *info) /* mul latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        mulps_rr(Xmm0, Xmm6)
+        mulps_rr(Xmm0, Xmm6)
+        mulps_rr(Xmm0, Xmm6)
+        mulps_rr(Xmm0, Xmm6))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench02(rt_SIMD_INFOX *info) /* mul throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        mulps3rr(Xmm0, Xmm6, Xmm7)
+        mulps3rr(Xmm1, Xmm6, Xmm7)
+        mulps3rr(Xmm2, Xmm6, Xmm7)
+        mulps3rr(Xmm3, Xmm6, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void l_bench03(rt_SIMD_INFOX *info) /* fma latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        fmaps_rr(Xmm0, Xmm6, Xmm7)
+        fmaps_rr(Xmm0, Xmm6, Xmm7)
+        fmaps_rr(Xmm0, Xmm6, Xmm7)
+        fmaps_rr(Xmm0, Xmm6, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+/*
+ * As fma always accumulates into its destination,
+ * throughput is measured with 4 independent chains.
+ */
+rt_void t_bench03(rt_SIMD_INFOX *info) /* fma throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        fmaps_rr(Xmm0, Xmm6, Xmm7)
+        fmaps_rr(Xmm1, Xmm6, Xmm7)
+        fmaps_rr(Xmm2, Xmm6, Xmm7)
+        fmaps_rr(Xmm3, Xmm6, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void l_bench04(rt_SIMD_INFOX *info) /* div latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        divps_rr(Xmm0, Xmm6)
+        divps_rr(Xmm0, Xmm6)
+        divps_rr(Xmm0, Xmm6)
+        divps_rr(Xmm0, Xmm6))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench04(rt_SIMD_INFOX *info) /* div throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        divps3rr(Xmm0, Xmm6, Xmm7)
+        divps3rr(Xmm1, Xmm6, Xmm7)
+        divps3rr(Xmm2, Xmm6, Xmm7)
+        divps3rr(Xmm3, Xmm6, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void l_bench05(rt_SIMD_INFOX *info) /* sqrt latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        sqrps_rr(Xmm0, Xmm0)
+        sqrps_rr(Xmm0, Xmm0)
+        sqrps_rr(Xmm0, Xmm0)
+        sqrps_rr(Xmm0, Xmm0))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench05(rt_SIMD_INFOX *info) /* sqrt throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        sqrps_rr(Xmm0, Xmm7)
+        sqrps_rr(Xmm1, Xmm7)
+        sqrps_rr(Xmm2, Xmm7)
+        sqrps_rr(Xmm3, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+/****************************   rcp/rsq estimates   ***************************/
+
+rt_void l_bench06(rt_SIMD_INFOX *info) /* rcp estimate latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        rceps_rr(Xmm1, Xmm0)
+        rceps_rr(Xmm0, Xmm1)
+        rceps_rr(Xmm1, Xmm0)
+        rceps_rr(Xmm0, Xmm1))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench06(rt_SIMD_INFOX *info) /* rcp estimate throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        rceps_rr(Xmm0, Xmm7)
+        rceps_rr(Xmm1, Xmm7)
+        rceps_rr(Xmm2, Xmm7)
+        rceps_rr(Xmm3, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void l_bench07(rt_SIMD_INFOX *info) /* rcp (refined) latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        rcpps_rr(Xmm1, Xmm0) /* destroys Xmm0 */
+        rcpps_rr(Xmm0, Xmm1) /* destroys Xmm1 */
+        rcpps_rr(Xmm1, Xmm0) /* destroys Xmm0 */
+        rcpps_rr(Xmm0, Xmm1)) /* destroys Xmm1 */
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench07(rt_SIMD_INFOX *info) /* rcp (refined) throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        movpx_rr(Xmm4, Xmm7)
+        rcpps_rr(Xmm0, Xmm4) /* destroys Xmm4 */
+        movpx_rr(Xmm5, Xmm7)
+        rcpps_rr(Xmm1, Xmm5) /* destroys Xmm5 */
+        movpx_rr(Xmm4, Xmm7)
+        rcpps_rr(Xmm2, Xmm4) /* destroys Xmm4 */
+        movpx_rr(Xmm5, Xmm7)
+        rcpps_rr(Xmm3, Xmm5)) /* destroys Xmm5 */
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void l_bench08(rt_SIMD_INFOX *info) /* rsq estimate latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        rseps_rr(Xmm1, Xmm0)
+        rseps_rr(Xmm0, Xmm1)
+        rseps_rr(Xmm1, Xmm0)
+        rseps_rr(Xmm0, Xmm1))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench08(rt_SIMD_INFOX *info) /* rsq estimate throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        rseps_rr(Xmm0, Xmm7)
+        rseps_rr(Xmm1, Xmm7)
+        rseps_rr(Xmm2, Xmm7)
+        rseps_rr(Xmm3, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void l_bench09(rt_SIMD_INFOX *info) /* rsq (refined) latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        rsqps_rr(Xmm1, Xmm0) /* destroys Xmm0 */
+        rsqps_rr(Xmm0, Xmm1) /* destroys Xmm1 */
+        rsqps_rr(Xmm1, Xmm0) /* destroys Xmm0 */
+        rsqps_rr(Xmm0, Xmm1)) /* destroys Xmm1 */
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench09(rt_SIMD_INFOX *info) /* rsq (refined) throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        movpx_rr(Xmm4, Xmm7)
+        rsqps_rr(Xmm0, Xmm4) /* destroys Xmm4 */
+        movpx_rr(Xmm5, Xmm7)
+        rsqps_rr(Xmm1, Xmm5) /* destroys Xmm5 */
+        movpx_rr(Xmm4, Xmm7)
+        rsqps_rr(Xmm2, Xmm4) /* destroys Xmm4 */
+        movpx_rr(Xmm5, Xmm7)
+        rsqps_rr(Xmm3, Xmm5)) /* destroys Xmm5 */
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+/*********************************   cbrt   ***********************************/
+
+rt_void l_bench10(rt_SIMD_INFOX *info) /* cbrt latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        cbrps_rr(Xmm1, Xmm4, Xmm5, Xmm0) /* destroys Xmm4, Xmm5 */
+        cbrps_rr(Xmm0, Xmm4, Xmm5, Xmm1) /* destroys Xmm4, Xmm5 */
+        cbrps_rr(Xmm1, Xmm4, Xmm5, Xmm0) /* destroys Xmm4, Xmm5 */
+        cbrps_rr(Xmm0, Xmm4, Xmm5, Xmm1)) /* destroys Xmm4, Xmm5 */
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench10(rt_SIMD_INFOX *info) /* cbrt throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        cbrps_rr(Xmm0, Xmm4, Xmm5, Xmm7) /* destroys Xmm4, Xmm5 */
+        cbrps_rr(Xmm1, Xmm4, Xmm5, Xmm7) /* destroys Xmm4, Xmm5 */
+        cbrps_rr(Xmm2, Xmm4, Xmm5, Xmm7) /* destroys Xmm4, Xmm5 */
+        cbrps_rr(Xmm3, Xmm4, Xmm5, Xmm7)) /* destroys Xmm4, Xmm5 */
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+/****************************   compares & masks   ****************************/
+
+/*
+ * Latency chain settles at all-zeros mask after the first compare.
+ */
+rt_void l_bench11(rt_SIMD_INFOX *info) /* cmp latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        cgtps_rr(Xmm0, Xmm6)
+        cgtps_rr(Xmm0, Xmm6)
+        cgtps_rr(Xmm0, Xmm6)
+        cgtps_rr(Xmm0, Xmm6))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench11(rt_SIMD_INFOX *info) /* cmp throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        cgtps3rr(Xmm0, Xmm6, Xmm7)
+        cgtps3rr(Xmm1, Xmm6, Xmm7)
+        cgtps3rr(Xmm2, Xmm6, Xmm7)
+        cgtps3rr(Xmm3, Xmm6, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+/*
+ * Single op is a compare followed by a mask-jump depending on it,
+ * masks are never FULL, therefore jumps are never taken.
+ */
+rt_void l_bench12(rt_SIMD_INFOX *info) /* cmp + mask-jump latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+        xorpx_rr(Xmm0, Xmm0)
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        cgtps_rr(Xmm0, Xmm6)
+        CHECK_MASK(100501f, FULL, Xmm0) /* cyc_end */
+        cgtps_rr(Xmm0, Xmm6)
+        CHECK_MASK(100501f, FULL, Xmm0) /* cyc_end */
+        cgtps_rr(Xmm0, Xmm6)
+        CHECK_MASK(100501f, FULL, Xmm0) /* cyc_end */
+        cgtps_rr(Xmm0, Xmm6)
+        CHECK_MASK(100501f, FULL, Xmm0)) /* cyc_end */
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    LBL(100501) /* cyc_end */
+
+    ASM_LEAVE(info)
+}
+
+/*
+ * Single op is a mask-jump on a precomputed mask.
+ */
+rt_void t_bench12(rt_SIMD_INFOX *info) /* mask-jump throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+        cgtps3rr(Xmm0, Xmm6, Xmm7)
+        cgtps3rr(Xmm1, Xmm6, Xmm7)
+        cgtps3rr(Xmm2, Xmm6, Xmm7)
+        cgtps3rr(Xmm3, Xmm6, Xmm7)
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        CHECK_MASK(100501f, FULL, Xmm0) /* cyc_end */
+        CHECK_MASK(100501f, FULL, Xmm1) /* cyc_end */
+        CHECK_MASK(100501f, FULL, Xmm2) /* cyc_end */
+        CHECK_MASK(100501f, FULL, Xmm3)) /* cyc_end */
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    LBL(100501) /* cyc_end */
+
+    ASM_LEAVE(info)
+}
+
+/****************************   gather emulation   ****************************/
+
+/*
+ * Single op is a full SIMD register gathered from the float array
+ * element by element using indices from the int array (iso2),
+ * which is how indexed (texture) fetches are done without native gathers.
+ * Ops are independent, thus there is no separate latency kernel.
+ */
+rt_void t_bench13(rt_SIMD_INFOX *info) /* gather throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        movxx_ld(Resi, Mebp, inf_ISO2)
+        movxx_ld(Redx, Mebp, inf_FSO2)
+        movwx_ri(Rebx, IB(S))
+
+    LBL(100501) /* elm_beg */
+
+        movyx_ld(Reax, Mesi, AJ0)
+        shlxx_ri(Reax, IB(L+1))
+        movyx_ld(Reax, Iecx, AJ0)
+        movyx_st(Reax, Medx, AJ0)
+
+        addxx_ri(Resi, IB(4*L))
+        addxx_ri(Redx, IB(4*L))
+        subwx_ri(Rebx, IB(1))
+        cmjwx_ri(Rebx, IB(0),
+        /* if */ GT_x, 100501b) /* elm_beg */
+
+        movxx_ld(Redx, Mebp, inf_FSO2)
+        movpx_ld(Xmm0, Medx, AJ0)
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+/**************************   horizontal reductions   *************************/
+
+/*
+ * Latency chain of sums overflows to infinity shortly,
+ * which doesn't affect timings on supported targets.
+ */
+rt_void l_bench14(rt_SIMD_INFOX *info) /* hadd latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        adhps_rr(Xmm1, Xmm0)
+        adhps_rr(Xmm0, Xmm1)
+        adhps_rr(Xmm1, Xmm0)
+        adhps_rr(Xmm0, Xmm1))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench14(rt_SIMD_INFOX *info) /* hadd throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        adhps_rr(Xmm0, Xmm7)
+        adhps_rr(Xmm1, Xmm7)
+        adhps_rr(Xmm2, Xmm7)
+        adhps_rr(Xmm3, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void l_bench15(rt_SIMD_INFOX *info) /* hmin latency */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        mnhps_rr(Xmm1, Xmm0)
+        mnhps_rr(Xmm0, Xmm1)
+        mnhps_rr(Xmm1, Xmm0)
+        mnhps_rr(Xmm0, Xmm1))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+rt_void t_bench15(rt_SIMD_INFOX *info) /* hmin throughput */
+{
+    ASM_ENTER(info)
+
+        BENCH_INIT()
+
+    LBL(100500) /* cyc_beg */
+
+        BENCH_BODY(
+        mnhps_rr(Xmm0, Xmm7)
+        mnhps_rr(Xmm1, Xmm7)
+        mnhps_rr(Xmm2, Xmm7)
+        mnhps_rr(Xmm3, Xmm7))
+
+        BENCH_LOOP(100500b) /* cyc_beg */
+
+    ASM_LEAVE(info)
+}
+
+struct benchXX
+{
+    const rt_char  *name;
+    testXX          l_fn;   /* latency kernel, RT_NULL if not applicable */
+    testXX          t_fn;   /* throughput kernel */
+    rt_si32         ops;    /* ops per loop cycle */
+};
+
+volatile
+benchXX b_test[] =
+{
+    {   "add",          l_bench01,  t_bench01,  BENCH_REPT  },
+    {   "mul",          l_bench02,  t_bench02,  BENCH_REPT  },
+    {   "fma",          l_bench03,  t_bench03,  BENCH_REPT  },
+    {   "div",          l_bench04,  t_bench04,  BENCH_REPT  },
+    {   "sqrt",         l_bench05,  t_bench05,  BENCH_REPT  },
+    {   "rcp est",      l_bench06,  t_bench06,  BENCH_REPT  },
+    {   "rcp",          l_bench07,  t_bench07,  BENCH_REPT  },
+    {   "rsq est",      l_bench08,  t_bench08,  BENCH_REPT  },
+    {   "rsq",          l_bench09,  t_bench09,  BENCH_REPT  },
+    {   "cbrt",         l_bench10,  t_bench10,  BENCH_REPT  },
+    {   "cmp",          l_bench11,  t_bench11,  BENCH_REPT  },
+    {   "mask jump",    l_bench12,  t_bench12,  BENCH_REPT  },
+    {   "gather emu",   RT_NULL,    t_bench13,  1           },
+    {   "hadd",         l_bench14,  t_bench14,  BENCH_REPT  },
+    {   "hmin",         l_bench15,  t_bench15,  BENCH_REPT  },
+};
+
 /******************************************************************************/
 /**********************************   MAIN   **********************************/
 /******************************************************************************/
@@ -8320,6 +9016,81 @@ testXX v_simd = simd_version;
 
 rt_time get_time();
 
+/*
+ * Run given benchmark kernel doubling the number of loop cycles
+ * until it takes at least "b_time" ms, return time in ns per single op.
+ */
+rt_fp64 bench_op(rt_SIMD_INFOX *inf0, testXX b_fn, rt_si32 ops)
+{
+    rt_time time1 = 0;
+    rt_time time2 = 0;
+    rt_si32 cyc = 256;
+
+    while (RT_TRUE)
+    {
+        inf0->cyc = cyc;
+
+        time1 = get_time();
+
+        b_fn(inf0);
+
+        time2 = get_time();
+
+        if (time2 - time1 >= b_time || cyc >= 0x04000000)
+        {
+            break;
+        }
+
+        cyc *= time2 - time1 < b_time / 8 ? 8 : 2;
+    }
+
+    return (time2 - time1) * 1000000.0 / ((rt_fp64)cyc * ops);
+}
+
+/*
+ * Print table of latencies and throughputs
+ * of benchmarked instruction families for current SIMD target.
+ */
+rt_void bench_run(rt_SIMD_INFOX *inf0, rt_si32 simd)
+{
+    rt_si32 i, j, n = RT_ARR_SIZE(b_test);
+
+    /* indices for gather emulation */
+    rt_elem *iso2 = inf0->iso2 + S*RT_OFFS_SIMD;
+
+    for (j = 0; j < S; j++)
+    {
+        iso2[j] = (j * 5 + 3) % inf0->size;
+    }
+
+    RT_LOGI("--------------------  BENCHMARK  - ptr/fp = %d%s%d --\n",
+                    RT_POINTER, RT_ADDRESS == 32 ? "_" : "f", RT_ELEMENT);
+    RT_LOGI("family        lat ns/op   thr ns/op  thr ns/elem\n");
+
+    for (i = 0; i < n; i++)
+    {
+        rt_fp64 t_op = bench_op(inf0, b_test[i].t_fn, b_test[i].ops);
+
+        if (b_test[i].l_fn != RT_NULL)
+        {
+            rt_fp64 l_op = bench_op(inf0, b_test[i].l_fn, b_test[i].ops);
+
+            RT_LOGI("%-12s %10.3f  %10.3f   %10.4f\n",
+                    b_test[i].name, l_op, t_op, t_op / S);
+        }
+        else
+        {
+            RT_LOGI("%-12s %10s  %10.3f   %10.4f\n",
+                    b_test[i].name, "-", t_op, t_op / S);
+        }
+    }
+
+    RT_LOGI("-------------------------------------- simd = %4dx%dv%d -\n",
+            (simd & 0xFF) * 128, (simd >> 16) & 0xFF, (simd >> 8) & 0xFF);
+
+    inf0->cyc = r_test;
+}
+
 /*
  * info - info original pointer
  * inf0 - info aligned pointer
@@ -8360,6 +9131,7 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
         RT_LOGI(" -d n, override diff-threshold for qualification, n >= 0\n");
         RT_LOGI(" -c n, override counter of redundant test cycles, n >= 1\n");
         RT_LOGI(" -v, enable verbose mode, always print values from tests\n");
+        RT_LOGI(" -t n, run throughput benchmark, n ms per kernel, n >= 1\n");
         RT_LOGI("all options can be used together\n");
         RT_LOGI("--------------------------------------------------------\n");
     }
@@ -8439,6 +9211,23 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
             v_mode = RT_TRUE;
             RT_LOGI("Verbose mode enabled\n");
         }
+        if (k < argc && strcmp(argv[k], "-t") == 0 && ++k < argc)
+        {
+            for (l = strlen(argv[k]), r = 1, t = 0; l > 0; l--, r *= 10)
+            {
+                t += (argv[k][l-1] - '0') * r;
+            }
+            if (t >= 1)
+            {
+                RT_LOGI("Benchmark-time overridden: %d\n", t);
+                b_time = t;
+            }
+            else
+            {
+                RT_LOGI("Benchmark-time value out of range\n");
+                return 0;
+            }
+        }
     }
 
 #if RT_OFFS_ALLOC
@@ -8658,6 +9447,13 @@ rt_si32 main(rt_si32 argc, rt_char *argv[])
 
     rt_si32 i, j;
 
+    /* throughput mode replaces validation */
+    if (b_time > 0 && n_done >= 0)
+    {
+        bench_run(inf0, simd);
+        n_done = n_init - 1;
+    }
+
     for (i = n_init; i <= n_done; i++)
     {
         RT_LOGI("--------------------  SUB TEST = %2d  - ptr/fp = %d%s%d --\n",